@@ -1,4 +1,5 @@
 #include "CoinTossManager.h"
+#include "MatchRandom.h"
 
 ACoinTossManager::ACoinTossManager()
 {
@@ -13,7 +14,7 @@ void ACoinTossManager::BeginPlay()
 bool ACoinTossManager::PerformCoinToss()
 {
 	// Randomly decide heads (true) or tails (false)
-	return FMath::RandBool();
+	return GetMatchRandomStream(this, EMatchRandomStream::CoinToss).RandBool();
 }
 
 void ACoinTossManager::DecideStartingPlayer()
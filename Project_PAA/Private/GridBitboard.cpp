@@ -0,0 +1,193 @@
+#include "GridBitboard.h"
+
+namespace
+{
+	// parola Word dello strato spostato di Shift bit verso indici più alti
+	FORCEINLINE uint64 ShiftedUp(const uint64* Words, int32 NumWords, int32 Word, int32 Shift)
+	{
+		const int32 Source = Word - (Shift >> 6);
+		const int32 Bits = Shift & 63;
+
+		uint64 Result = (Source >= 0 && Source < NumWords) ? Words[Source] << Bits : 0;
+		if (Bits != 0 && Source - 1 >= 0 && Source - 1 < NumWords)
+		{
+			Result |= Words[Source - 1] >> (64 - Bits);
+		}
+		return Result;
+	}
+
+	// parola Word dello strato spostato di Shift bit verso indici più bassi
+	FORCEINLINE uint64 ShiftedDown(const uint64* Words, int32 NumWords, int32 Word, int32 Shift)
+	{
+		const int32 Source = Word + (Shift >> 6);
+		const int32 Bits = Shift & 63;
+
+		uint64 Result = (Source >= 0 && Source < NumWords) ? Words[Source] >> Bits : 0;
+		if (Bits != 0 && Source + 1 >= 0 && Source + 1 < NumWords)
+		{
+			Result |= Words[Source + 1] << (64 - Bits);
+		}
+		return Result;
+	}
+}
+
+void FGridBitboard::Init(int32 InSizeX, int32 InSizeY)
+{
+	if (SizeX == InSizeX && SizeY == InSizeY) return;
+
+	SizeX = InSizeX;
+	SizeY = InSizeY;
+
+	const int32 NumCells = SizeX * SizeY;
+	FirstYCells.Init(NumCells);
+	LastYCells.Init(NumCells);
+	for (int32 X = 0; X < SizeX; X++)
+	{
+		FirstYCells.Set(X * SizeY, true);
+		LastYCells.Set(X * SizeY + SizeY - 1, true);
+	}
+
+	ExpandScratch.Init(NumCells);
+	Diamonds.Reset();
+}
+
+void FGridBitboard::Expand(const FGridBitLayer& In, FGridBitLayer& Out, int32 FirstWord, int32 LastWord) const
+{
+	const uint64* Source = In.Words.GetData();
+	const uint64* FirstY = FirstYCells.Words.GetData();
+	const uint64* LastY = LastYCells.Words.GetData();
+	uint64* Dest = Out.Words.GetData();
+	const int32 NumWords = In.Words.Num();
+
+	for (int32 Word = FirstWord; Word <= LastWord; Word++)
+	{
+		// Y + 1 non arriva dalla riga prima, Y - 1 non arriva dalla riga dopo
+		uint64 Result = Source[Word];
+		Result |= ShiftedUp(Source, NumWords, Word, 1) & ~FirstY[Word];
+		Result |= ShiftedDown(Source, NumWords, Word, 1) & ~LastY[Word];
+		Result |= ShiftedUp(Source, NumWords, Word, SizeY);
+		Result |= ShiftedDown(Source, NumWords, Word, SizeY);
+		Dest[Word] = Result;
+	}
+
+	// niente bit oltre la griglia nell'ultima parola
+	if (LastWord == NumWords - 1 && (In.NumBits & 63) != 0)
+	{
+		Dest[LastWord] &= (1ull << (In.NumBits & 63)) - 1;
+	}
+}
+
+int32 FGridBitboard::FloodFill(const FGridBitLayer& Seeds, const FGridBitLayer& Passable, int32 MaxSteps, FGridBitLayer& Out,
+	int32 StopAt)
+{
+	Out.CopyFrom(Seeds);
+	if (ExpandScratch.NumBits != Out.NumBits)
+	{
+		ExpandScratch.Init(Out.NumBits);
+	}
+
+	// finestra delle parole che possono cambiare: cresce di una riga per lato a ogni passo
+	const int32 NumWords = Out.Words.Num();
+	int32 FirstWord = 0;
+	while (FirstWord < NumWords && Out.Words[FirstWord] == 0) FirstWord++;
+	if (FirstWord == NumWords) return 0;
+
+	int32 LastWord = NumWords - 1;
+	while (Out.Words[LastWord] == 0) LastWord--;
+
+	const int32 Spread = (SizeY >> 6) + 1;
+	int32 Steps = 0;
+	while (MaxSteps < 0 || Steps < MaxSteps)
+	{
+		if (StopAt != INDEX_NONE && Out.Get(StopAt)) break;
+
+		FirstWord = FMath::Max(0, FirstWord - Spread);
+		LastWord = FMath::Min(NumWords - 1, LastWord + Spread);
+		Expand(Out, ExpandScratch, FirstWord, LastWord);
+
+		bool bChanged = false;
+		for (int32 Word = FirstWord; Word <= LastWord; Word++)
+		{
+			const uint64 Reached = Out.Words[Word] | (ExpandScratch.Words[Word] & Passable.Words[Word]);
+			bChanged |= Reached != Out.Words[Word];
+			Out.Words[Word] = Reached;
+		}
+		if (!bChanged) break;
+
+		Steps++;
+	}
+	return Steps;
+}
+
+bool FGridBitboard::IsReachableWithin(const FGridBoardState& Board, int32 OriginIndex, int32 TargetIndex, int32 MaxSteps)
+{
+	const int32 NumCells = Board.NumCells();
+	if (OriginIndex < 0 || OriginIndex >= NumCells || TargetIndex < 0 || TargetIndex >= NumCells) return false;
+	if (OriginIndex == TargetIndex) return true;
+	if (Board.IsBlocked(TargetIndex) || Board.GetDistance(OriginIndex, TargetIndex) > MaxSteps) return false;
+
+	Init(Board.SizeX, Board.SizeY);
+	GetPassable(Board, PassableScratch);
+
+	if (SeedScratch.NumBits != NumCells)
+	{
+		SeedScratch.Init(NumCells);
+	}
+	else
+	{
+		SeedScratch.Reset();
+	}
+	SeedScratch.Set(OriginIndex, true);
+
+	FloodFill(SeedScratch, PassableScratch, MaxSteps, ReachedScratch, TargetIndex);
+	return ReachedScratch.Get(TargetIndex);
+}
+
+const FGridBitLayer& FGridBitboard::GetDiamond(int32 CenterIndex, int32 Radius)
+{
+	const uint64 Key = (static_cast<uint64>(Radius) << 32) | static_cast<uint32>(CenterIndex);
+	if (const FGridBitLayer* Cached = Diamonds.Find(Key))
+	{
+		return *Cached;
+	}
+
+	if (Diamonds.Num() >= MaxCachedDiamonds)
+	{
+		Diamonds.Reset();
+	}
+
+	FGridBitLayer& Diamond = Diamonds.Add(Key);
+	Diamond.Init(SizeX * SizeY);
+	if (CenterIndex < 0 || CenterIndex >= SizeX * SizeY || Radius < 0) return Diamond;
+
+	// una riga di X alla volta: le celle del rombo sono un tratto contiguo di Y
+	const int32 CenterX = CenterIndex / SizeY;
+	const int32 CenterY = CenterIndex % SizeY;
+	for (int32 X = FMath::Max(0, CenterX - Radius); X <= FMath::Min(SizeX - 1, CenterX + Radius); X++)
+	{
+		const int32 HalfWidth = Radius - FMath::Abs(X - CenterX);
+		const int32 MinY = FMath::Max(0, CenterY - HalfWidth);
+		const int32 MaxY = FMath::Min(SizeY - 1, CenterY + HalfWidth);
+		Diamond.SetRange(X * SizeY + MinY, MaxY - MinY + 1);
+	}
+	return Diamond;
+}
+
+void FGridBitboard::GetPassable(const FGridBoardState& Board, FGridBitLayer& Out)
+{
+	Out.SetToComplement(Board.Obstacles);
+	Out.AndNotWith(Board.Occupied);
+}
+
+void FGridBitboard::GetTeamUnits(const FGridBoardState& Board, bool bPlayerTeam, FGridBitLayer& Out)
+{
+	Out.CopyFrom(Board.Occupied);
+	if (bPlayerTeam)
+	{
+		Out.AndWith(Board.PlayerOwned);
+	}
+	else
+	{
+		Out.AndNotWith(Board.PlayerOwned);
+	}
+}
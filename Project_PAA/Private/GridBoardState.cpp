@@ -0,0 +1,174 @@
+#include "GridBoardState.h"
+
+void FGridBitLayer::Init(int32 InNumBits)
+{
+	NumBits = InNumBits;
+	Words.Reset();
+	Words.SetNumZeroed((InNumBits + 63) >> 6);
+}
+
+void FGridBitLayer::Reset()
+{
+	FMemory::Memzero(Words.GetData(), Words.Num() * sizeof(uint64));
+}
+
+int32 FGridBitLayer::CountSetBits() const
+{
+	int32 Count = 0;
+	for (uint64 Word : Words)
+	{
+		Count += FPlatformMath::CountBits(Word);
+	}
+	return Count;
+}
+
+bool FGridBitLayer::IsEmpty() const
+{
+	for (uint64 Word : Words)
+	{
+		if (Word != 0) return false;
+	}
+	return true;
+}
+
+void FGridBitLayer::SetRange(int32 Start, int32 Count)
+{
+	int32 Index = Start;
+	const int32 End = Start + Count;
+	while (Index < End)
+	{
+		const int32 Bit = Index & 63;
+		const int32 NumInWord = FMath::Min(64 - Bit, End - Index);
+		const uint64 Mask = NumInWord == 64 ? ~0ull : ((1ull << NumInWord) - 1) << Bit;
+		Words[Index >> 6] |= Mask;
+		Index += NumInWord;
+	}
+}
+
+void FGridBitLayer::CopyFrom(const FGridBitLayer& Other)
+{
+	NumBits = Other.NumBits;
+	Words = Other.Words;
+}
+
+void FGridBitLayer::AndWith(const FGridBitLayer& Other)
+{
+	uint64* RESTRICT Dest = Words.GetData();
+	const uint64* RESTRICT Src = Other.Words.GetData();
+	for (int32 i = 0, Num = Words.Num(); i < Num; i++)
+	{
+		Dest[i] &= Src[i];
+	}
+}
+
+void FGridBitLayer::OrWith(const FGridBitLayer& Other)
+{
+	uint64* RESTRICT Dest = Words.GetData();
+	const uint64* RESTRICT Src = Other.Words.GetData();
+	for (int32 i = 0, Num = Words.Num(); i < Num; i++)
+	{
+		Dest[i] |= Src[i];
+	}
+}
+
+void FGridBitLayer::AndNotWith(const FGridBitLayer& Other)
+{
+	uint64* RESTRICT Dest = Words.GetData();
+	const uint64* RESTRICT Src = Other.Words.GetData();
+	for (int32 i = 0, Num = Words.Num(); i < Num; i++)
+	{
+		Dest[i] &= ~Src[i];
+	}
+}
+
+void FGridBitLayer::SetToComplement(const FGridBitLayer& Other)
+{
+	if (NumBits != Other.NumBits)
+	{
+		Init(Other.NumBits);
+	}
+
+	uint64* RESTRICT Dest = Words.GetData();
+	const uint64* RESTRICT Src = Other.Words.GetData();
+	for (int32 i = 0, Num = Words.Num(); i < Num; i++)
+	{
+		Dest[i] = ~Src[i];
+	}
+
+	// l'ultima parola ha bit oltre la griglia
+	if ((NumBits & 63) != 0)
+	{
+		Words.Last() &= (1ull << (NumBits & 63)) - 1;
+	}
+}
+
+void FGridBoardState::Init(int32 InSizeX, int32 InSizeY)
+{
+	SizeX = InSizeX;
+	SizeY = InSizeY;
+
+	Obstacles.Init(NumCells());
+	Occupied.Init(NumCells());
+	PlayerOwned.Init(NumCells());
+
+	UnitIds.Reset();
+	UnitIds.Init(INDEX_NONE, NumCells());
+
+	Revision++;
+}
+
+void FGridBoardState::SetObstacle(int32 Index, bool bObstacle)
+{
+	Obstacles.Set(Index, bObstacle);
+	Revision++;
+}
+
+void FGridBoardState::SetUnit(int32 Index, int32 UnitId, bool bIsPlayer)
+{
+	Occupied.Set(Index, true);
+	PlayerOwned.Set(Index, bIsPlayer);
+	UnitIds[Index] = UnitId;
+	Revision++;
+}
+
+void FGridBoardState::ClearUnit(int32 Index)
+{
+	Occupied.Set(Index, false);
+	PlayerOwned.Set(Index, false);
+	UnitIds[Index] = INDEX_NONE;
+	Revision++;
+}
+
+void FGridChangeLog::Reset(const FGridBoardState& Board)
+{
+	BaseRevision = Board.Revision;
+	Revisions.Reset();
+	Cells.Reset();
+}
+
+void FGridChangeLog::Record(const FGridBoardState& Board, int32 Index)
+{
+	// piena: si butta la metà più vecchia, chi è rimasto così indietro ricalcola da zero
+	if (Revisions.Num() >= MaxEntries)
+	{
+		const int32 NumDropped = MaxEntries / 2;
+		BaseRevision = Revisions[NumDropped - 1];
+		Revisions.RemoveAt(0, NumDropped, EAllowShrinking::No);
+		Cells.RemoveAt(0, NumDropped, EAllowShrinking::No);
+	}
+
+	Revisions.Add(Board.Revision);
+	Cells.Add(Index);
+}
+
+bool FGridChangeLog::GetChangesSince(uint32 Revision, TArray<int32>& OutCells) const
+{
+	OutCells.Reset();
+	if (Revision < BaseRevision) return false;
+
+	for (int32 Entry = Revisions.Num() - 1; Entry >= 0 && Revisions[Entry] > Revision; Entry--)
+	{
+		OutCells.Add(Cells[Entry]);
+	}
+	return true;
+}
@@ -1,10 +1,10 @@
 #include "GridCell.h"
 #include "GridManager.h"
 #include "Unit.h"
-#include "MyGameMode.h"
 #include "Engine/World.h"
 #include "Logging/LogMacros.h"
 #include "Materials/MaterialInstanceDynamic.h"
+#include "MatchRandom.h"
 
 AGridCell::AGridCell()
 {
@@ -36,45 +36,17 @@ AGridCell::AGridCell()
     static ConstructorHelpers::FObjectFinder<UMaterialInterface> MoveMatFinder(TEXT("/Game/StarterContent/Materials/M_Metal_Gold.M_Metal_Gold"));
     HighlightMoveMaterial = MoveMatFinder.Object;
 
+    // solo visiva: i click li risolve il GridManager dal piano della griglia
     if (CellMesh)
     {
-        CellMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-        CellMesh->SetCollisionObjectType(ECC_WorldStatic);
-        CellMesh->SetCollisionResponseToAllChannels(ECR_Ignore);
-        CellMesh->SetCollisionResponseToChannel(ECC_Visibility, ECR_Block);
-        CellMesh->SetCollisionResponseToChannel(ECC_WorldDynamic, ECR_Block);
-        CellMesh->SetCollisionResponseToChannel(ECC_Pawn, ECR_Block);
+        CellMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+        CellMesh->SetGenerateOverlapEvents(false);
     }
 }
 
 void AGridCell::BeginPlay()
 {
     Super::BeginPlay();
-
-    EnableInput(GetWorld()->GetFirstPlayerController());
-
-    if (UStaticMeshComponent* MeshComponent = FindComponentByClass<UStaticMeshComponent>())
-    {
-        MeshComponent->OnClicked.AddDynamic(this, &AGridCell::OnCellClicked);
-    }
-}
-
-void AGridCell::OnCellClicked(UPrimitiveComponent* ClickedComponent, FKey ButtonPressed)
-{
-    AMyGameMode* GameMode = Cast<AMyGameMode>(GetWorld()->GetAuthGameMode());
-    if (!GameMode) return;
-
-    if (GameMode->CurrentGamePhase == EGamePhase::Placement)
-    {
-        GameMode->HandleUnitPlacement(FVector2D(GridPositionX, GridPositionY));
-    }
-    else if (GameMode->CurrentGamePhase == EGamePhase::UnitAction)
-    {
-        if (GameMode->GridManager)
-        {
-            GameMode->GridManager->HandleCellClick(this);
-        }
-    }
 }
 
 void AGridCell::SetObstacle(bool bObstacle)
@@ -82,23 +54,36 @@ void AGridCell::SetObstacle(bool bObstacle)
     if (bIsObstacle == bObstacle) return;
 
     bIsObstacle = bObstacle;
+    if (!bDrawsObstacle) return;
+
+    if (bUsesSharedMaterial)
+    {
+        const float Shade = bIsObstacle ? GetMatchRandomStream(this, EMatchRandomStream::Cosmetic).FRandRange(0.3f, 1.0f) : 1.0f;
+        CellMesh->SetCustomPrimitiveDataFloat(CustomDataObstacle, bIsObstacle ? 1.0f : 0.0f);
+        CellMesh->SetCustomPrimitiveDataFloat(CustomDataShade, Shade);
+        CellMesh->SetWorldScale3D(GetCellScale(bIsObstacle));
+        return;
+    }
 
     if (bIsObstacle && ObstacleMaterial)
     {
-        UMaterialInstanceDynamic* DynamicMat = UMaterialInstanceDynamic::Create(ObstacleMaterial, this);
-        if (DynamicMat)
+        if (!ObstacleMID)
         {
-            float Shade = FMath::RandRange(0.3f, 1.0f);
-            DynamicMat->SetVectorParameterValue(FName("ColorTint"), FLinearColor(Shade, Shade, Shade, 1.0f));
-            CellMesh->SetMaterial(0, DynamicMat);
-            CellMesh->SetWorldScale3D(FVector(1.2f, 1.2f, 2.0f));
+            ObstacleMID = UMaterialInstanceDynamic::Create(ObstacleMaterial, this);
+        }
+        if (ObstacleMID)
+        {
+            float Shade = GetMatchRandomStream(this, EMatchRandomStream::Cosmetic).FRandRange(0.3f, 1.0f);
+            ObstacleMID->SetVectorParameterValue(FName("ColorTint"), FLinearColor(Shade, Shade, Shade, 1.0f));
+            CellMesh->SetMaterial(0, ObstacleMID);
+            CellMesh->SetWorldScale3D(GetCellScale(true));
             CellMesh->MarkRenderStateDirty();
         }
     }
     else if (DefaultMaterial)
     {
         CellMesh->SetMaterial(0, DefaultMaterial);
-        CellMesh->SetWorldScale3D(FVector(1.0f, 1.0f, 0.1f));
+        CellMesh->SetWorldScale3D(GetCellScale(false));
         CellMesh->MarkRenderStateDirty();
     }
 }
@@ -134,49 +119,85 @@ int32 AGridCell::GetGridPositionY() const { return GridPositionY; }
 
 void AGridCell::SetUnit(AUnit* Unit)
 {
+    // la board del GridManager è autoritativa, la cella riflette solo lo stato
+    if (AGridManager* GridManager = Cast<AGridManager>(GetOwner()))
+    {
+        GridManager->SetCellUnit(GridPositionX, GridPositionY, Unit);
+        return;
+    }
+
     bIsOccupied = (Unit != nullptr);
-    UE_LOG(LogTemp, Warning, TEXT("Cell %s at (%d,%d) - Occupation set to: %s"), 
-        *CellName, GridPositionX, GridPositionY, 
-        bIsOccupied ? TEXT("Occupied") : TEXT("Empty"));
 }
 
 AUnit* AGridCell::GetUnit() const
 {
-    TArray<AActor*> OverlappingActors;
-    GetOverlappingActors(OverlappingActors, AUnit::StaticClass());
-
-    if (OverlappingActors.Num() > 0)
+    // lettura dal registro del GridManager, niente query di overlap
+    if (const AGridManager* GridManager = Cast<AGridManager>(GetOwner()))
     {
-        if (AUnit* FoundUnit = Cast<AUnit>(OverlappingActors[0]))
-        {
-            UE_LOG(LogTemp, Log, TEXT("Cell %s at (%d,%d) - Found unit: %s"), 
-                *CellName, GridPositionX, GridPositionY, *FoundUnit->GetName());
-            return FoundUnit;
-        }
+        return GridManager->GetUnitAt(GridPositionX, GridPositionY);
     }
-
-    UE_LOG(LogTemp, Log, TEXT("Cell %s at (%d,%d) - No unit found"), 
-        *CellName, GridPositionX, GridPositionY);
     return nullptr;
 }
 
+void AGridCell::UseSharedMaterial(UMaterialInterface* SharedMaterial, FLinearColor InDefaultHighlightColor)
+{
+    if (!CellMesh || !SharedMaterial) return;
+
+    bUsesSharedMaterial = true;
+    DefaultHighlightColor = InDefaultHighlightColor;
+
+    // unico cambio di materiale della cella: da qui in poi solo custom data
+    CellMesh->SetMaterial(0, SharedMaterial);
+    CellMesh->SetCustomPrimitiveDataVector4(CustomDataHighlight, FVector4(DefaultHighlightColor.R, DefaultHighlightColor.G, DefaultHighlightColor.B, 0.0f));
+    CellMesh->SetCustomPrimitiveDataFloat(CustomDataObstacle, bIsObstacle ? 1.0f : 0.0f);
+    CellMesh->SetCustomPrimitiveDataFloat(CustomDataShade, 1.0f);
+}
+
 void AGridCell::SetHighlight(bool bHighlight)
 {
     if (IsObstacle()) return;
 
+    if (bUsesSharedMaterial)
+    {
+        CellMesh->SetCustomPrimitiveDataVector4(CustomDataHighlight,
+            FVector4(DefaultHighlightColor.R, DefaultHighlightColor.G, DefaultHighlightColor.B, bHighlight ? 1.0f : 0.0f));
+        return;
+    }
+
     if (CellMesh && DefaultMaterial && HighlightMoveMaterial)
     {
-        CellMesh->SetMaterial(0, bHighlight ? DefaultMaterial : HighlightMoveMaterial);
+        CellMesh->SetMaterial(0, bHighlight ? HighlightMoveMaterial : DefaultMaterial);
     }
 }
 
+void AGridCell::SetHighlightMaterial(UMaterialInterface* Material)
+{
+    if (IsObstacle() || !CellMesh || !Material) return;
+
+    CellMesh->SetMaterial(0, Material);
+}
+
 void AGridCell::SetHighlightColor(FLinearColor NewColor)
 {
     if (!CellMesh) return;
 
-    UMaterialInstanceDynamic* DynMat = CellMesh->CreateAndSetMaterialInstanceDynamic(0);
-    if (DynMat)
+    if (bUsesSharedMaterial)
     {
-        DynMat->SetVectorParameterValue("Color", NewColor);
+        CellMesh->SetCustomPrimitiveDataVector4(CustomDataHighlight, FVector4(NewColor.R, NewColor.G, NewColor.B, 1.0f));
+        return;
+    }
+
+    // MID creato una volta sola e rimesso sulla mesh se nel frattempo è cambiato il materiale
+    if (!HighlightMID)
+    {
+        HighlightMID = UMaterialInstanceDynamic::Create(DefaultMaterial ? DefaultMaterial : CellMesh->GetMaterial(0), this);
+    }
+    if (HighlightMID)
+    {
+        HighlightMID->SetVectorParameterValue("Color", NewColor);
+        if (CellMesh->GetMaterial(0) != HighlightMID)
+        {
+            CellMesh->SetMaterial(0, HighlightMID);
+        }
     }
 }
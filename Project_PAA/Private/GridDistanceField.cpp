@@ -0,0 +1,339 @@
+#include "GridDistanceField.h"
+
+namespace
+{
+	FORCEINLINE int32 GetNeighbours(const FGridBoardState& Board, int32 Index, int32 (&OutNeighbours)[4])
+	{
+		const int32 SizeY = Board.SizeY;
+		const int32 X = Index / SizeY;
+		const int32 Y = Index % SizeY;
+
+		int32 NumNeighbours = 0;
+		if (X + 1 < Board.SizeX) OutNeighbours[NumNeighbours++] = Index + SizeY;
+		if (X > 0)               OutNeighbours[NumNeighbours++] = Index - SizeY;
+		if (Y + 1 < SizeY)       OutNeighbours[NumNeighbours++] = Index + 1;
+		if (Y > 0)               OutNeighbours[NumNeighbours++] = Index - 1;
+		return NumNeighbours;
+	}
+
+	FORCEINLINE uint64 MakeHeapKey(int32 InDistance, int32 Index)
+	{
+		return (static_cast<uint64>(InDistance) << 32) | static_cast<uint32>(Index);
+	}
+}
+
+void FGridDistanceField::Begin(const FGridBoardState& Board)
+{
+	const int32 NumCells = Board.NumCells();
+	if (Distance.Num() != NumCells)
+	{
+		Distance.Init(INDEX_NONE, NumCells);
+		Label.Init(INDEX_NONE, NumCells);
+	}
+	else
+	{
+		// pulisce solo le celle scritte dall'ultima costruzione
+		for (int32 Index : Queue)
+		{
+			Distance[Index] = INDEX_NONE;
+			Label[Index] = INDEX_NONE;
+		}
+	}
+
+	Queue.Reset();
+	Sources.Reset();
+	BoardRevision = Board.Revision;
+	bBuilt = true;
+	bRepairing = false;
+}
+
+void FGridDistanceField::AddSource(int32 Index, int32 InLabel)
+{
+	if (bRepairing)
+	{
+		PendingSources.Add(FIntPoint(Index, InLabel));
+		return;
+	}
+
+	if (Distance[Index] != INDEX_NONE) return;
+
+	Distance[Index] = 0;
+	Label[Index] = InLabel;
+	Queue.Add(Index);
+	Sources.Add(Index);
+}
+
+void FGridDistanceField::Propagate(const FGridBoardState& Board, bool bInExpandBlockedSources)
+{
+	const int32 SizeY = Board.SizeY;
+	bExpandBlockedSources = bInExpandBlockedSources;
+
+	for (int32 Head = 0; Head < Queue.Num(); Head++)
+	{
+		const int32 Current = Queue[Head];
+		if (!bExpandBlockedSources && Board.IsBlocked(Current)) continue;
+
+		const int32 NewDistance = Distance[Current] + 1;
+		const int32 X = Current / SizeY;
+		const int32 Y = Current % SizeY;
+
+		int32 Neighbours[4];
+		int32 NumNeighbours = 0;
+		if (X + 1 < Board.SizeX) Neighbours[NumNeighbours++] = Current + SizeY;
+		if (X > 0)               Neighbours[NumNeighbours++] = Current - SizeY;
+		if (Y + 1 < SizeY)       Neighbours[NumNeighbours++] = Current + 1;
+		if (Y > 0)               Neighbours[NumNeighbours++] = Current - 1;
+
+		for (int32 i = 0; i < NumNeighbours; i++)
+		{
+			const int32 Next = Neighbours[i];
+			if (Distance[Next] != INDEX_NONE || Board.IsBlocked(Next)) continue;
+
+			Distance[Next] = NewDistance;
+			Label[Next] = Label[Current];
+			Queue.Add(Next);
+		}
+	}
+}
+
+int32 FGridDistanceField::GetDistanceFromBlocked(const FGridBoardState& Board, int32 Index, int32* OutLabel) const
+{
+	if (OutLabel) *OutLabel = GetLabel(Index);
+	if (!Distance.IsValidIndex(Index) || Distance[Index] != INDEX_NONE) return GetDistance(Index);
+
+	const int32 SizeY = Board.SizeY;
+	const int32 X = Index / SizeY;
+	const int32 Y = Index % SizeY;
+
+	int32 Neighbours[4];
+	int32 NumNeighbours = 0;
+	if (X + 1 < Board.SizeX) Neighbours[NumNeighbours++] = Index + SizeY;
+	if (X > 0)               Neighbours[NumNeighbours++] = Index - SizeY;
+	if (Y + 1 < SizeY)       Neighbours[NumNeighbours++] = Index + 1;
+	if (Y > 0)               Neighbours[NumNeighbours++] = Index - 1;
+
+	int32 Best = INDEX_NONE;
+	for (int32 i = 0; i < NumNeighbours; i++)
+	{
+		const int32 Next = Neighbours[i];
+		if (Distance[Next] == INDEX_NONE) continue;
+
+		// sorgente bloccata non espansa (es. cella d'attacco occupata): non ci si può entrare
+		if (!bExpandBlockedSources && Board.IsBlocked(Next)) continue;
+
+		if (Best == INDEX_NONE || Distance[Next] + 1 < Best)
+		{
+			Best = Distance[Next] + 1;
+			if (OutLabel) *OutLabel = Label[Next];
+		}
+	}
+	return Best;
+}
+
+void FGridDistanceField::BeginRepair()
+{
+	bRepairing = true;
+	PendingSources.Reset();
+}
+
+void FGridDistanceField::FlagCell(int32 Index, uint8 Flag)
+{
+	if (RepairFlags[Index] == 0)
+	{
+		RepairTouched.Add(Index);
+	}
+	RepairFlags[Index] |= Flag;
+}
+
+int32 FGridDistanceField::Repair(const FGridBoardState& Board, const TArray<int32>& ChangedCells)
+{
+	bRepairing = false;
+
+	const int32 NumCells = Board.NumCells();
+	if (RepairFlags.Num() != NumCells)
+	{
+		RepairFlags.Init(0, NumCells);
+	}
+	RepairTouched.Reset();
+	RepairAffected.Reset();
+	RepairHeap.Reset();
+
+	int32 Neighbours[4];
+
+	// sorgenti nuove (la prima su una cella vince, come in AddSource); quelle spostate o
+	// rietichettate invalidano ciò che dipendeva da loro
+	int32 NumNewSources = 0;
+	for (const FIntPoint& Source : PendingSources)
+	{
+		if (RepairFlags[Source.X] & NewSource) continue;
+
+		FlagCell(Source.X, NewSource);
+		PendingSources[NumNewSources++] = Source;
+		if (Distance[Source.X] == 0 && Label[Source.X] != Source.Y)
+		{
+			FlagCell(Source.X, Seed);
+		}
+	}
+	PendingSources.SetNum(NumNewSources, EAllowShrinking::No);
+
+	for (int32 Source : Sources)
+	{
+		if (!(RepairFlags[Source] & NewSource))
+		{
+			FlagCell(Source, Seed);
+		}
+	}
+
+	// le celle cambiate possono aver perso (o guadagnato) la capacità di propagare
+	for (int32 Index : ChangedCells)
+	{
+		FlagCell(Index, Seed);
+	}
+
+	for (int32 Index : RepairTouched)
+	{
+		if ((RepairFlags[Index] & Seed) && Distance[Index] != INDEX_NONE)
+		{
+			RepairHeap.HeapPush(MakeHeapKey(Distance[Index], Index));
+		}
+	}
+
+	// Invalidazione per livelli di distanza crescente: una cella resta valida se ha ancora un vicino
+	// valido e propagante a distanza - 1; altrimenti cade e trascina i vicini a distanza + 1
+	while (RepairHeap.Num() > 0)
+	{
+		uint64 Key;
+		RepairHeap.HeapPop(Key, EAllowShrinking::No);
+		const int32 Current = static_cast<int32>(Key & 0xffffffffull);
+		const int32 CurrentDistance = static_cast<int32>(Key >> 32);
+
+		if (RepairFlags[Current] & Visited) continue;
+		FlagCell(Current, Visited);
+
+		const int32 NumNeighbours = GetNeighbours(Board, Current, Neighbours);
+		if (!(RepairFlags[Current] & Seed))
+		{
+			bool bSupported = false;
+			for (int32 i = 0; i < NumNeighbours && !bSupported; i++)
+			{
+				const int32 Prev = Neighbours[i];
+				bSupported = Distance[Prev] == CurrentDistance - 1 && !(RepairFlags[Prev] & Affected) &&
+					IsExpandable(Board, Prev);
+			}
+			if (bSupported) continue;
+		}
+
+		FlagCell(Current, Affected);
+		RepairAffected.Add(Current);
+
+		for (int32 i = 0; i < NumNeighbours; i++)
+		{
+			const int32 Next = Neighbours[i];
+			if (Distance[Next] == CurrentDistance + 1 && !(RepairFlags[Next] & Visited))
+			{
+				RepairHeap.HeapPush(MakeHeapKey(CurrentDistance + 1, Next));
+			}
+		}
+	}
+
+	for (int32 Index : RepairAffected)
+	{
+		Distance[Index] = INDEX_NONE;
+		Label[Index] = INDEX_NONE;
+	}
+
+	int32 NumWritten = 0;
+	auto WriteCell = [&](int32 Index, int32 NewDistance, int32 NewLabel)
+	{
+		Distance[Index] = NewDistance;
+		Label[Index] = NewLabel;
+		Queue.Add(Index);
+		RepairHeap.HeapPush(MakeHeapKey(NewDistance, Index));
+		NumWritten++;
+	};
+
+	Sources.Reset();
+	for (const FIntPoint& Source : PendingSources)
+	{
+		Sources.Add(Source.X);
+		if (Distance[Source.X] != 0)
+		{
+			WriteCell(Source.X, 0, Source.Y);
+		}
+	}
+
+	// celle invalidate o cambiate: si ripartono dal miglior vicino rimasto valido
+	auto Reseed = [&](int32 Index)
+	{
+		if (Distance[Index] != INDEX_NONE || Board.IsBlocked(Index)) return;
+
+		int32 Best = INDEX_NONE;
+		const int32 NumNeighbours = GetNeighbours(Board, Index, Neighbours);
+		for (int32 i = 0; i < NumNeighbours; i++)
+		{
+			const int32 Prev = Neighbours[i];
+			if (Distance[Prev] != INDEX_NONE && IsExpandable(Board, Prev) &&
+				(Best == INDEX_NONE || Distance[Prev] < Distance[Best]))
+			{
+				Best = Prev;
+			}
+		}
+		if (Best != INDEX_NONE)
+		{
+			WriteCell(Index, Distance[Best] + 1, Label[Best]);
+		}
+	};
+	for (int32 Index : RepairAffected)
+	{
+		Reseed(Index);
+	}
+	for (int32 Index : ChangedCells)
+	{
+		Reseed(Index);
+	}
+
+	// propagazione a costo unitario da distanze di partenza diverse: serve la coda con priorità.
+	// Abbassa anche le celle rimaste valide a cui ora conviene un'altra strada.
+	while (RepairHeap.Num() > 0)
+	{
+		uint64 Key;
+		RepairHeap.HeapPop(Key, EAllowShrinking::No);
+		const int32 Current = static_cast<int32>(Key & 0xffffffffull);
+		const int32 CurrentDistance = static_cast<int32>(Key >> 32);
+
+		if (Distance[Current] != CurrentDistance || !IsExpandable(Board, Current)) continue;
+
+		const int32 NumNeighbours = GetNeighbours(Board, Current, Neighbours);
+		for (int32 i = 0; i < NumNeighbours; i++)
+		{
+			const int32 Next = Neighbours[i];
+			if (Board.IsBlocked(Next)) continue;
+
+			if (Distance[Next] == INDEX_NONE || CurrentDistance + 1 < Distance[Next])
+			{
+				WriteCell(Next, CurrentDistance + 1, Label[Current]);
+			}
+		}
+	}
+
+	for (int32 Index : RepairTouched)
+	{
+		RepairFlags[Index] = 0;
+	}
+
+	// l'elenco delle celle scritte cresce a ogni riparazione: ogni tanto si compatta
+	if (Queue.Num() > NumCells)
+	{
+		Queue.Reset();
+		for (int32 Index = 0; Index < NumCells; Index++)
+		{
+			if (Distance[Index] != INDEX_NONE)
+			{
+				Queue.Add(Index);
+			}
+		}
+	}
+
+	BoardRevision = Board.Revision;
+	return RepairAffected.Num() + NumWritten;
+}
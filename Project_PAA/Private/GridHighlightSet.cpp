@@ -0,0 +1,59 @@
+#include "GridHighlightSet.h"
+
+void FGridHighlightSet::Reset(int32 NumCells)
+{
+	Desired.Init(0, NumCells);
+	Applied.Init(0, NumCells);
+	IsTouched.Init(false, NumCells);
+	Touched.Reset();
+	Lit.Reset();
+}
+
+void FGridHighlightSet::Set(int32 CellIndex, EGridHighlightKind Kind)
+{
+	if (!Desired.IsValidIndex(CellIndex)) return;
+
+	Desired[CellIndex] = static_cast<uint8>(Kind);
+	if (!IsTouched[CellIndex])
+	{
+		IsTouched[CellIndex] = true;
+		Touched.Add(CellIndex);
+	}
+}
+
+void FGridHighlightSet::ClearAll()
+{
+	// basta spegnere ciò che è acceso o sta per accendersi
+	for (int32 CellIndex : Lit)
+	{
+		Set(CellIndex, EGridHighlightKind::None);
+	}
+	for (int32 CellIndex : Touched)
+	{
+		Desired[CellIndex] = static_cast<uint8>(EGridHighlightKind::None);
+	}
+}
+
+int32 FGridHighlightSet::Flush(FApplyFunction Apply)
+{
+	int32 NumChanged = 0;
+
+	for (int32 CellIndex : Touched)
+	{
+		IsTouched[CellIndex] = false;
+		if (Desired[CellIndex] == Applied[CellIndex]) continue;
+
+		// una cella accesa per la prima volta entra in Lit; quelle spente escono sotto
+		if (Applied[CellIndex] == 0)
+		{
+			Lit.Add(CellIndex);
+		}
+		Applied[CellIndex] = Desired[CellIndex];
+		Apply(CellIndex, static_cast<EGridHighlightKind>(Desired[CellIndex]));
+		NumChanged++;
+	}
+	Touched.Reset();
+
+	Lit.RemoveAll([this](int32 CellIndex) { return Applied[CellIndex] == 0; });
+	return NumChanged;
+}
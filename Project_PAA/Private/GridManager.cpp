@@ -10,12 +10,22 @@
 #include "Templates/Greater.h"           // per TGreater<>
 #include "WBP_ActionWidget.h"
 #include "Kismet/GameplayStatics.h"
+#include "MatchRandom.h"
+#include "GridPathBenchmark.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Components/InputComponent.h"
+#include "InputCoreTypes.h"
 
 // Constructor
 AGridManager::AGridManager()
 {
-    PrimaryActorTick.bCanEverTick = false;
+    // tick solo per l'anteprima del percorso sotto il cursore, acceso da SetMoveTargeting
+    PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bStartWithTickEnabled = false;
     bGridCreated = false;
+    Pathfinder.SetStaticDistances(&StaticDistances);
     /*// materiale di default per la griglia
     static ConstructorHelpers::FObjectFinder<UMaterialInterface> DefaultMatFinder(
         TEXT("/Game/StarterContent/Materials/M_Water_Lake.M_Water_Lake"));
@@ -60,12 +70,25 @@ void AGridManager::BeginPlay()
         UE_LOG(LogTemp, Error, TEXT("Failed to get GameMode!"));
     }
 
+    // un solo binding per tutti i click sulla griglia, al posto di un OnClicked per cella e per unità
+    if (APlayerController* PlayerController = GetWorld()->GetFirstPlayerController())
+    {
+        EnableInput(PlayerController);
+        if (InputComponent)
+        {
+            InputComponent->BindKey(EKeys::LeftMouseButton, IE_Pressed, this, &AGridManager::OnLeftMouseClick);
+        }
+    }
+
     // Create the grid
     CreateGrid();
 
     // Generate obstacles
     GenerateObstacles();
 
+    // da qui gli ostacoli sono fissi: distanze statiche una volta sola
+    BuildStaticDistances();
+
     if (!DefaultTileMaterial) UE_LOG(LogTemp, Error, TEXT("DefaultTileMaterial non caricato!"));
     if (!HighlightMoveMaterial) UE_LOG(LogTemp, Error, TEXT("HighlightMoveMaterial non caricato!"));
     if (!HighlightAttackMaterial) UE_LOG(LogTemp, Error, TEXT("HighlightAttackMaterial non caricato!"));
@@ -90,6 +113,28 @@ void AGridManager::CreateGrid()
     }
     GridCells.Empty();
 
+    // Indice denso: ogni (X,Y) ha il suo slot anche se lo spawn fallisce
+    GridCells.SetNumZeroed(GetNumCells());
+    Board.Init(GridSizeX, GridSizeY);
+    BoardChanges.Reset(Board);
+    Bitboard.Init(GridSizeX, GridSizeY);
+    UnitIndex.Init(GridSizeX, GridSizeY);
+    Highlights.Reset(GetNumCells());
+
+    if (ObstacleMesh)
+    {
+        CreateObstacleInstances();
+    }
+
+    if (bUseInstancedCells)
+    {
+        // nessun attore: celle come istanze, il resto lavora già per indice
+        CreateCellInstances();
+        bGridCreated = true;
+        UE_LOG(LogTemp, Warning, TEXT("Grid creation completed with %d instanced cells."), GetNumCells());
+        return;
+    }
+
     // Create new grid cells
     for (int32 X = 0; X < GridSizeX; X++)
     {
@@ -102,23 +147,22 @@ void AGridManager::CreateGrid()
                 NewCell->SetCellName(FString::Printf(TEXT("%c%d"), 'A' + X, Y + 1));
                 NewCell->SetGridPosition(X, Y);
                 NewCell->SetOwner(this);
-                // Debug: Visualize collision
-                NewCell->CellMesh->SetHiddenInGame(false);
-                NewCell->CellMesh->SetVisibility(true);
-                
-                if (UStaticMeshComponent* Mesh = NewCell->FindComponentByClass<UStaticMeshComponent>())
+                NewCell->SetDrawsObstacle(ObstacleInstances == nullptr);
+                if (SharedCellMaterial)
                 {
-                    Mesh->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-                    Mesh->SetCollisionResponseToAllChannels(ECR_Ignore);
-                    Mesh->SetCollisionResponseToChannel(ECC_Visibility, ECR_Block);
-                    Mesh->SetCollisionResponseToChannel(ECC_WorldDynamic, ECR_Block);
+                    NewCell->UseSharedMaterial(SharedCellMaterial, HighlightMoveColor);
                 }
+                NewCell->CellMesh->SetHiddenInGame(false);
+                NewCell->CellMesh->SetVisibility(true);
                 
-                GridCells.Add(NewCell);
+                GridCells[GetCellIndex(X, Y)] = NewCell;
                 UE_LOG(LogTemp, Warning, TEXT("Created grid cell at (%d, %d)"), X, Y);
             }
             else
             {
+                // cella mancante = non calpestabile
+                Board.SetObstacle(GetCellIndex(X, Y), true);
+                NotifyCellChanged(GetCellIndex(X, Y));
                 UE_LOG(LogTemp, Error, TEXT("Failed to spawn grid cell at (%d, %d)"), X, Y);
             }
         }
@@ -128,12 +172,273 @@ void AGridManager::CreateGrid()
     UE_LOG(LogTemp, Warning, TEXT("Grid creation completed with %d cells."), GridCells.Num());
 }
 
+void AGridManager::CreateCellInstances()
+{
+    if (!CellInstances)
+    {
+        UStaticMesh* PlaneMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Plane.Plane"));
+
+        CellInstances = NewObject<UInstancedStaticMeshComponent>(this, TEXT("CellInstances"));
+        CellInstances->SetStaticMesh(PlaneMesh);
+        CellInstances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+        CellInstances->SetGenerateOverlapEvents(false);
+        AttachGridComponent(CellInstances);
+    }
+
+    if (!SharedCellMaterial)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("bUseInstancedCells senza SharedCellMaterial: highlight e ostacoli non si vedono sulle celle"));
+    }
+
+    CellInstances->ClearInstances();
+    CellInstances->SetMaterial(0, SharedCellMaterial ? SharedCellMaterial : DefaultTileMaterial);
+    CellInstances->SetNumCustomDataFloats(AGridCell::CustomDataShade + 1);
+
+    // istanza i = cella i: le trasformazioni in un blocco solo
+    TArray<FTransform> Transforms;
+    Transforms.Reserve(GetNumCells());
+    for (int32 Index = 0; Index < GetNumCells(); Index++)
+    {
+        const FIntPoint Coord = GetCellCoord(Index);
+        Transforms.Add(FTransform(FRotator::ZeroRotator, GetCellWorldPosition(Coord.X, Coord.Y), AGridCell::GetCellScale(false)));
+    }
+    CellInstances->AddInstances(Transforms, false, true);
+
+    // highlight spento col colore del movimento, niente ostacolo, tinta neutra
+    const float Defaults[] = { HighlightMoveColor.R, HighlightMoveColor.G, HighlightMoveColor.B, 0.0f, 0.0f, 1.0f };
+    for (int32 Index = 0; Index < GetNumCells(); Index++)
+    {
+        CellInstances->SetCustomData(Index, MakeArrayView(Defaults), false);
+    }
+    CellInstances->MarkRenderStateDirty();
+
+    InstancedObstacles.Init(GetNumCells());
+}
+
+void AGridManager::CreateObstacleInstances()
+{
+    if (!ObstacleInstances)
+    {
+        ObstacleInstances = NewObject<UHierarchicalInstancedStaticMeshComponent>(this, TEXT("ObstacleInstances"));
+        ObstacleInstances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+        ObstacleInstances->SetGenerateOverlapEvents(false);
+        AttachGridComponent(ObstacleInstances);
+    }
+
+    ObstacleInstances->ClearInstances();
+    ObstacleInstances->SetStaticMesh(ObstacleMesh);
+    if (ObstacleInstanceMaterial)
+    {
+        ObstacleInstances->SetMaterial(0, ObstacleInstanceMaterial);
+    }
+    ObstacleInstances->SetNumCustomDataFloats(1);
+
+    ObstacleInstanceOfCell.Init(INDEX_NONE, GetNumCells());
+    ObstacleInstanceCells.Reset();
+    ObstacleInstanceShades.Reset();
+}
+
+void AGridManager::AddObstacleInstance(int32 Index)
+{
+    if (ObstacleInstanceOfCell[Index] != INDEX_NONE) return;
+
+    const FIntPoint Coord = GetCellCoord(Index);
+    const float Shade = GetMatchRandomStream(this, EMatchRandomStream::Cosmetic).FRandRange(0.3f, 1.0f);
+
+    const int32 Instance = ObstacleInstances->AddInstance(FTransform(GetCellWorldPosition(Coord.X, Coord.Y)), true);
+    ensure(Instance == ObstacleInstanceCells.Num());
+    ObstacleInstances->SetCustomDataValue(Instance, 0, Shade, true);
+
+    ObstacleInstanceOfCell[Index] = Instance;
+    ObstacleInstanceCells.Add(Index);
+    ObstacleInstanceShades.Add(Shade);
+}
+
+void AGridManager::RemoveObstacleInstance(int32 Index)
+{
+    const int32 Instance = ObstacleInstanceOfCell[Index];
+    if (Instance == INDEX_NONE) return;
+
+    // l'ultima istanza si sposta nel buco (trasformazione e tinta), poi si toglie l'ultima:
+    // nessun altro indice cambia e la HISM non riordina nulla
+    const int32 Last = ObstacleInstanceCells.Num() - 1;
+    if (Instance != Last)
+    {
+        const int32 MovedCell = ObstacleInstanceCells[Last];
+        const FIntPoint Coord = GetCellCoord(MovedCell);
+        ObstacleInstances->UpdateInstanceTransform(Instance, FTransform(GetCellWorldPosition(Coord.X, Coord.Y)), true, false, true);
+        ObstacleInstances->SetCustomDataValue(Instance, 0, ObstacleInstanceShades[Last], false);
+
+        ObstacleInstanceCells[Instance] = MovedCell;
+        ObstacleInstanceShades[Instance] = ObstacleInstanceShades[Last];
+        ObstacleInstanceOfCell[MovedCell] = Instance;
+    }
+
+    ObstacleInstances->RemoveInstance(Last);
+    ObstacleInstanceCells.Pop();
+    ObstacleInstanceShades.Pop();
+    ObstacleInstanceOfCell[Index] = INDEX_NONE;
+    ObstacleInstances->MarkRenderStateDirty();
+}
+
+void AGridManager::AttachGridComponent(USceneComponent* Component)
+{
+    if (!RootComponent)
+    {
+        SetRootComponent(Component);
+    }
+    else
+    {
+        Component->SetupAttachment(RootComponent);
+    }
+    Component->RegisterComponent();
+    AddInstanceComponent(Component);
+}
+
+void AGridManager::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    UpdateHoverPreview();
+}
+
+void AGridManager::SetMoveTargeting(bool bActive)
+{
+    SetActorTickEnabled(bActive && bShowHoverPathPreview);
+    if (!bActive)
+    {
+        ClearHoverPreview();
+    }
+}
+
+void AGridManager::UpdateHoverPreview()
+{
+    AUnit* Unit = GameMode && GameMode->bWaitingForMoveTarget ? GameMode->SelectedUnit : nullptr;
+    if (!bShowHoverPathPreview || !Unit)
+    {
+        ClearHoverPreview();
+        return;
+    }
+
+    // il cursore si legge una volta per frame: più movimenti nello stesso frame = un aggiornamento
+    int32 Index = INDEX_NONE;
+    GetCellUnderCursor(Index);
+    if (Index == HoverCellIndex) return;
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    // solo dalla cache della selezione; se la BFS è ancora sul worker si riprova al prossimo frame
+    const FVector2D Origin = Unit->GetGridPosition();
+    const int32 OriginX = FMath::RoundToInt(Origin.X);
+    const int32 OriginY = FMath::RoundToInt(Origin.Y);
+    if (!IsValidCoord(OriginX, OriginY)) return;
+
+    const int32 OriginIndex = GetCellIndex(OriginX, OriginY);
+    const FGridReachability* Reach = FindCachedReachability(OriginIndex, Unit->MovementRange);
+    if (!Reach)
+    {
+        Reach = RepairCachedReachability(OriginIndex, Unit->MovementRange);
+    }
+    if (!Reach) return;
+
+    HoverCellIndex = Index;
+    HoverPathScratch.Reset();
+    if (Index != INDEX_NONE)
+    {
+        // vuoto se la cella non è raggiungibile
+        Reach->BuildPath(Index, HoverPathScratch);
+    }
+
+    // il percorso vecchio torna range di movimento, il nuovo si accende (origine esclusa):
+    // le celle in comune non cambiano e il flush non le tocca
+    for (int32 CellIndex : HoverPath)
+    {
+        if (Highlights.Get(CellIndex) == EGridHighlightKind::PathPreview)
+        {
+            Highlights.Set(CellIndex, EGridHighlightKind::Move);
+        }
+    }
+    HoverPath.Reset();
+    for (int32 CellIndex : HoverPathScratch)
+    {
+        if (CellIndex == OriginIndex) continue;
+
+        Highlights.Set(CellIndex, EGridHighlightKind::PathPreview);
+        HoverPath.Add(CellIndex);
+    }
+
+    // siamo già nel tick del frame: si applica ora invece di aspettare il flush del frame dopo
+    FlushHighlights();
+
+    const double LatencyMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    HoverLatencySumMs += LatencyMs;
+    HoverLatencyMaxMs = FMath::Max(HoverLatencyMaxMs, LatencyMs);
+    HoverLatencySamples++;
+}
+
+void AGridManager::ClearHoverPreview()
+{
+    if (HoverPath.Num() == 0 && HoverCellIndex == INDEX_NONE && HoverLatencySamples == 0) return;
+
+    for (int32 CellIndex : HoverPath)
+    {
+        if (Highlights.Get(CellIndex) == EGridHighlightKind::PathPreview)
+        {
+            Highlights.Set(CellIndex, EGridHighlightKind::Move);
+        }
+    }
+    RequestHighlightFlush();
+    HoverPath.Reset();
+    HoverCellIndex = INDEX_NONE;
+
+    if (HoverLatencySamples > 0)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Hover path preview: %d aggiornamenti, latenza media %.3f ms, max %.3f ms"),
+            HoverLatencySamples, HoverLatencySumMs / HoverLatencySamples, HoverLatencyMaxMs);
+        HoverLatencySumMs = 0.0;
+        HoverLatencyMaxMs = 0.0;
+        HoverLatencySamples = 0;
+    }
+}
+
+void AGridManager::OnLeftMouseClick()
+{
+    int32 Index = INDEX_NONE;
+    if (GetCellUnderCursor(Index))
+    {
+        HandleCellClick(Index);
+    }
+}
+
+bool AGridManager::GetCellUnderCursor(int32& OutIndex) const
+{
+    APlayerController* PlayerController = GetWorld() ? GetWorld()->GetFirstPlayerController() : nullptr;
+    FVector RayOrigin, RayDirection;
+    if (!PlayerController || !PlayerController->DeprojectMousePositionToWorld(RayOrigin, RayDirection)) return false;
+
+    // piano orizzontale alla quota delle celle; raggio parallelo o rivolto verso l'alto = niente
+    const float PlaneZ = GetCellWorldPosition(0, 0).Z;
+    if (RayDirection.Z > -KINDA_SMALL_NUMBER) return false;
+
+    const float T = (PlaneZ - RayOrigin.Z) / RayDirection.Z;
+    if (T < 0.0f) return false;
+
+    // celle centrate su (X, Y) * CellSize: si arrotonda al centro più vicino
+    const FVector HitPoint = RayOrigin + RayDirection * T;
+    const int32 X = FMath::RoundToInt(HitPoint.X / CellSize);
+    const int32 Y = FMath::RoundToInt(HitPoint.Y / CellSize);
+    if (!IsValidCoord(X, Y)) return false;
+
+    OutIndex = GetCellIndex(X, Y);
+    return true;
+}
+
 
 
 // Generate obstacles
 void AGridManager::GenerateObstacles()
 {
-    if (!ObstacleBlueprint)
+    if (!ObstacleBlueprint && !ObstacleInstances)
     {
         UE_LOG(LogTemp, Error, TEXT("ObstacleBlueprint is not set!"));
         return;
@@ -141,24 +446,39 @@ void AGridManager::GenerateObstacles()
 
     UE_LOG(LogTemp, Warning, TEXT("Generating obstacles with probability: %f"), SpawnProbability);
 
-    TArray<TArray<bool>> LocalObstacleMap;
+    FGridBitLayer LocalObstacleMap;
     CreateObstacleMap(LocalObstacleMap);
 
+    if (ObstacleInstances)
+    {
+        // le istanze nascono da SetCellObstacle; l'albero della HISM si costruisce una volta alla fine
+        ObstacleInstances->bAutoRebuildTreeOnInstanceChanges = false;
+        for (int32 Index = 0; Index < GetNumCells(); Index++)
+        {
+            if (LocalObstacleMap.Get(Index))
+            {
+                const FIntPoint Coord = GetCellCoord(Index);
+                SetCellObstacle(Coord.X, Coord.Y, true);
+            }
+        }
+        ObstacleInstances->bAutoRebuildTreeOnInstanceChanges = true;
+        ObstacleInstances->BuildTreeIfOutdated(false, true);
+
+        UE_LOG(LogTemp, Warning, TEXT("Obstacle generation completed: %d instances."), ObstacleInstanceCells.Num());
+        return;
+    }
+
     for (int32 X = 0; X < GridSizeX; X++)
     {
         for (int32 Y = 0; Y < GridSizeY; Y++)
         {
-            if (LocalObstacleMap[X][Y]) // If the cell should contain an obstacle
+            if (LocalObstacleMap.Get(GetCellIndex(X, Y))) // If the cell should contain an obstacle
             {
                 FVector TilePosition = GetCellWorldPosition(X, Y);
                 AActor* NewObstacle = GetWorld()->SpawnActor<AActor>(ObstacleBlueprint, TilePosition, FRotator::ZeroRotator);
                 if (NewObstacle)
                 {
-                    AGridCell* Cell = GetCellAtPosition(FVector2D(X, Y));
-                    if (Cell)
-                    {
-                        Cell->SetObstacle(true);
-                    }
+                    SetCellObstacle(X, Y, true);
                 }
                 else
                 {
@@ -172,89 +492,204 @@ void AGridManager::GenerateObstacles()
 }
 
 // Create the obstacle map
-void AGridManager::CreateObstacleMap(TArray<TArray<bool>>& OutObstacleMap) const
+void AGridManager::CreateObstacleMap(FGridBitLayer& OutObstacleMap) const
 {
-    // Ensure OutObstacleMap has correct dimensions
-    OutObstacleMap.SetNum(GridSizeX);
-    for (int32 X = 0; X < GridSizeX; X++)
-    {
-        OutObstacleMap[X].SetNum(GridSizeY, EAllowShrinking::No);
-        for (int32 Y = 0; Y < GridSizeY; Y++)
-        {
-            OutObstacleMap[X][Y] = false; // Initialize as empty
-        }
-    }
+    // Ensure OutObstacleMap has correct dimensions, all empty
+    OutObstacleMap.Init(GetNumCells());
+
+    // scratch per il controllo incrementale, allocato una volta sola
+    TArray<uint32> VisitStamp;
+    VisitStamp.Init(0, GetNumCells());
+    uint32 Stamp = 0;
+    TArray<int32> Queue;
+    Queue.Reserve(GetNumCells());
+
+    int32 FreeCellCount = GetNumCells();
+    int32 Mismatches = 0;
+
+    FPcg32& Random = GetMatchRandomStream(this, EMatchRandomStream::Obstacles);
 
     for (int32 X = 0; X < GridSizeX; X++)
     {
         for (int32 Y = 0; Y < GridSizeY; Y++)
         {
-            if (FMath::FRand() <= SpawnProbability)
+            if (Random.FRand() <= SpawnProbability)
             {
-                OutObstacleMap[X][Y] = true;
+                const int32 Index = GetCellIndex(X, Y);
+                bool bKeepsConnectivity = true;
+
+                if (ObstacleConnectivityCheck == EObstacleConnectivityCheck::Exhaustive)
+                {
+                    OutObstacleMap.Set(Index, true);
+                    bKeepsConnectivity = AreAllCellsReachable(OutObstacleMap);
+                }
+                else
+                {
+                    // la mappa è connessa per costruzione: basta un controllo attorno alla cella
+                    bKeepsConnectivity = CanAddObstacleKeepingConnectivity(OutObstacleMap, X, Y, FreeCellCount, VisitStamp, Stamp, Queue);
+                    OutObstacleMap.Set(Index, true);
+
+                    if (ObstacleConnectivityCheck == EObstacleConnectivityCheck::CrossCheck &&
+                        bKeepsConnectivity != AreAllCellsReachable(OutObstacleMap))
+                    {
+                        Mismatches++;
+                        UE_LOG(LogTemp, Error, TEXT("Obstacle connectivity mismatch at (%d, %d): incremental=%d"), X, Y, bKeepsConnectivity);
+                        bKeepsConnectivity = !bKeepsConnectivity; // vale il validatore esaustivo
+                    }
+                }
 
                 // Validate connectivity
-                if (!AreAllCellsReachable(OutObstacleMap))
+                if (!bKeepsConnectivity)
                 {
-                    OutObstacleMap[X][Y] = false; // Remove obstacle if it blocks paths
+                    OutObstacleMap.Set(Index, false); // Remove obstacle if it blocks paths
+                }
+                else
+                {
+                    FreeCellCount--;
                 }
             }
         }
     }
+
+    if (ObstacleConnectivityCheck == EObstacleConnectivityCheck::CrossCheck)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Obstacle connectivity cross-check: %d mismatches"), Mismatches);
+    }
 }
 
-// Check if all cells are reachable
-bool AGridManager::AreAllCellsReachable(const TArray<TArray<bool>>& InObstacleMap) const
+bool AGridManager::CanAddObstacleKeepingConnectivity(const FGridBitLayer& InObstacleMap, int32 X, int32 Y, int32 FreeCellCount,
+    TArray<uint32>& VisitStamp, uint32& Stamp, TArray<int32>& Queue) const
 {
-    // Initialize visited map
-    TArray<TArray<bool>> Visited;
-    Visited.SetNum(GridSizeX);
-    for (int32 X = 0; X < GridSizeX; X++)
+    // l'ultima cella libera non può diventare ostacolo (nessuna cella vuota)
+    if (FreeCellCount <= 1) return false;
+
+    auto IsFree = [&](int32 CX, int32 CY)
+    {
+        return IsValidCoord(CX, CY) && !InObstacleMap.Get(GetCellIndex(CX, CY));
+    };
+
+    // vicini ortogonali in ordine circolare (su, destra, giù, sinistra) e diagonali tra uno e l'altro
+    static const FIntPoint Orthogonal[4] = { FIntPoint(0, 1), FIntPoint(1, 0), FIntPoint(0, -1), FIntPoint(-1, 0) };
+    static const FIntPoint Diagonal[4] = { FIntPoint(1, 1), FIntPoint(1, -1), FIntPoint(-1, -1), FIntPoint(-1, 1) };
+
+    bool bFree[4];
+    int32 NumFree = 0;
+    for (int32 i = 0; i < 4; i++)
     {
-        Visited[X].SetNum(GridSizeY, EAllowShrinking::No);
+        bFree[i] = IsFree(X + Orthogonal[i].X, Y + Orthogonal[i].Y);
+        NumFree += bFree[i] ? 1 : 0;
     }
 
-    // Find a starting cell that is not an obstacle
-    int32 StartX = -1, StartY = -1;
-    for (int32 X = 0; X < GridSizeX; X++)
+    // mappa connessa con più di una cella libera: almeno un vicino libero esiste
+    if (NumFree <= 1) return true;
+
+    // test locale: i vicini liberi sono collegati tramite l'anello degli 8 vicini?
+    int32 Group[4] = { 0, 1, 2, 3 };
+    for (int32 i = 0; i < 4; i++)
     {
-        for (int32 Y = 0; Y < GridSizeY; Y++)
+        const int32 Next = (i + 1) % 4;
+        if (bFree[i] && bFree[Next] && IsFree(X + Diagonal[i].X, Y + Diagonal[i].Y))
         {
-            if (!InObstacleMap[X][Y])
-            {
-                StartX = X;
-                StartY = Y;
-                break;
-            }
+            const int32 From = Group[Next];
+            const int32 To = Group[i];
+            for (int32& G : Group) { if (G == From) G = To; }
         }
-        if (StartX != -1) break;
     }
 
-    if (StartX == -1) return false; // No empty cells
+    int32 FirstGroup = INDEX_NONE;
+    bool bLocallyConnected = true;
+    for (int32 i = 0; i < 4; i++)
+    {
+        if (!bFree[i]) continue;
+        if (FirstGroup == INDEX_NONE) FirstGroup = Group[i];
+        else if (Group[i] != FirstGroup) bLocallyConnected = false;
+    }
+    if (bLocallyConnected) return true;
+
+    // fallback: BFS dal primo vicino libero con (X,Y) bloccata, esce appena li trova tutti
+    if (++Stamp == 0)
+    {
+        FMemory::Memzero(VisitStamp.GetData(), VisitStamp.Num() * sizeof(uint32));
+        Stamp = 1;
+    }
 
-    // Perform BFS to visit all reachable cells
-    BFS(InObstacleMap, Visited, StartX, StartY);
+    const int32 Blocked = GetCellIndex(X, Y);
+    VisitStamp[Blocked] = Stamp;
 
-    // Check if all non-obstacle cells were visited
-    for (int32 X = 0; X < GridSizeX; X++)
+    int32 Targets[4];
+    int32 NumTargets = 0;
+    for (int32 i = 0; i < 4; i++)
     {
-        for (int32 Y = 0; Y < GridSizeY; Y++)
+        if (bFree[i]) Targets[NumTargets++] = GetCellIndex(X + Orthogonal[i].X, Y + Orthogonal[i].Y);
+    }
+
+    Queue.Reset();
+    Queue.Add(Targets[0]);
+    VisitStamp[Targets[0]] = Stamp;
+    int32 Remaining = NumTargets - 1;
+
+    for (int32 Head = 0; Head < Queue.Num(); Head++)
+    {
+        const FIntPoint Current = GetCellCoord(Queue[Head]);
+        bool bDone = false;
+
+        ForEachNeighbour(Current.X, Current.Y, [&](int32 NX, int32 NY, int32 Next)
         {
-            if (!InObstacleMap[X][Y] && !Visited[X][Y])
+            if (bDone || VisitStamp[Next] == Stamp || InObstacleMap.Get(Next)) return;
+
+            VisitStamp[Next] = Stamp;
+            Queue.Add(Next);
+
+            for (int32 t = 1; t < NumTargets; t++)
             {
-                return false; // Unreachable cell found
+                if (Targets[t] == Next && --Remaining == 0)
+                {
+                    bDone = true;
+                }
             }
+        });
+
+        if (bDone) return true;
+    }
+
+    return false;
+}
+
+// Check if all cells are reachable
+bool AGridManager::AreAllCellsReachable(const FGridBitLayer& InObstacleMap) const
+{
+    // celle libere = complemento degli ostacoli; flood fill a bit dalla prima libera
+    FGridBitLayer& Passable = BitScratchA;
+    FGridBitLayer& Reached = BitScratchB;
+    Bitboard.Init(GridSizeX, GridSizeY);
+    Passable.SetToComplement(InObstacleMap);
+
+    int32 StartIndex = INDEX_NONE;
+    for (int32 Word = 0; Word < Passable.Words.Num() && StartIndex == INDEX_NONE; Word++)
+    {
+        if (Passable.Words[Word] != 0)
+        {
+            StartIndex = Word * 64 + FMath::CountTrailingZeros64(Passable.Words[Word]);
         }
     }
-    return true; // All cells are reachable
+
+    if (StartIndex == INDEX_NONE) return false; // No empty cells
+
+    FGridBitLayer Seed;
+    Seed.Init(Passable.NumBits);
+    Seed.Set(StartIndex, true);
+    Bitboard.FloodFill(Seed, Passable, -1, Reached);
+
+    // tutte le celle libere raggiunte?
+    return Reached.CountSetBits() == Passable.CountSetBits();
 }
 
 // BFS implementation
-void AGridManager::BFS(const TArray<TArray<bool>>& InObstacleMap, TArray<TArray<bool>>& Visited, int32 StartX, int32 StartY) const
+void AGridManager::BFS(const FGridBitLayer& InObstacleMap, FGridBitLayer& Visited, int32 StartX, int32 StartY) const
 {
     TQueue<FIntPoint> Queue;
     Queue.Enqueue(FIntPoint(StartX, StartY));
-    Visited[StartX][StartY] = true;
+    Visited.Set(GetCellIndex(StartX, StartY), true);
 
     while (!Queue.IsEmpty())
     {
@@ -262,7 +697,7 @@ void AGridManager::BFS(const TArray<TArray<bool>>& InObstacleMap, TArray<TArray<
         Queue.Dequeue(Current);
 
         // Check adjacent cells (up, down, left, right)
-        TArray<FIntPoint> Directions = { FIntPoint(-1, 0), FIntPoint(1, 0), FIntPoint(0, -1), FIntPoint(0, 1) };
+        static const FIntPoint Directions[4] = { FIntPoint(-1, 0), FIntPoint(1, 0), FIntPoint(0, -1), FIntPoint(0, 1) };
         for (const FIntPoint& Dir : Directions)
         {
             int32 NewX = Current.X + Dir.X;
@@ -270,9 +705,9 @@ void AGridManager::BFS(const TArray<TArray<bool>>& InObstacleMap, TArray<TArray<
 
             // Check if the new cell is valid, not an obstacle, and not visited
             if (NewX >= 0 && NewX < GridSizeX && NewY >= 0 && NewY < GridSizeY &&
-                !InObstacleMap[NewX][NewY] && !Visited[NewX][NewY])
+                !InObstacleMap.Get(GetCellIndex(NewX, NewY)) && !Visited.Get(GetCellIndex(NewX, NewY)))
             {
-                Visited[NewX][NewY] = true;
+                Visited.Set(GetCellIndex(NewX, NewY), true);
                 Queue.Enqueue(FIntPoint(NewX, NewY));
             }
         }
@@ -280,12 +715,20 @@ void AGridManager::BFS(const TArray<TArray<bool>>& InObstacleMap, TArray<TArray<
 }
 
 // Function to handle cell clicks
-void AGridManager::HandleCellClick(AGridCell* ClickedCell)
+void AGridManager::HandleCellClick(int32 Index)
 {
-    if (!GameMode || !ClickedCell) return;
+    if (!GameMode || Index < 0 || Index >= GetNumCells()) return;
+
+    if (GameMode->CurrentGamePhase == EGamePhase::Placement)
+    {
+        const FIntPoint Coord = GetCellCoord(Index);
+        GameMode->HandleUnitPlacement(FVector2D(Coord.X, Coord.Y));
+        return;
+    }
+    if (GameMode->CurrentGamePhase != EGamePhase::UnitAction) return;
 
     // Se la cella ha un'unità
-    if (AUnit* ClickedUnit = ClickedCell->GetUnit())
+    if (AUnit* ClickedUnit = GetUnitAtIndex(Index))
     {
         // Se è la stessa unità già selezionata e l'highlight è attivo
         if (GameMode->SelectedUnit == ClickedUnit && CurrentlyHighlightedUnit == ClickedUnit)
@@ -306,7 +749,7 @@ void AGridManager::HandleCellClick(AGridCell* ClickedCell)
     // Gestione del movimento
     else if (GameMode->bWaitingForMoveTarget && GameMode->SelectedUnit)
     {
-        TryMoveSelectedUnit(ClickedCell);
+        TryMoveSelectedUnit(Index);
         CurrentlyHighlightedUnit = nullptr;
     }
 
@@ -314,39 +757,49 @@ void AGridManager::HandleCellClick(AGridCell* ClickedCell)
     // Attack case
     else if (GameMode->bWaitingForAttack && GameMode->SelectedUnit)
     {
-        TryAttackSelectedUnit(ClickedCell);
+        TryAttackSelectedUnit(Index);
     }
 }
 
 
-void AGridManager::TryMoveSelectedUnit(AGridCell* TargetCell)
+void AGridManager::TryMoveSelectedUnit(int32 TargetIndex)
 {
-    if (!GameMode || !GameMode->SelectedUnit || !TargetCell) return;
+    if (!GameMode || !GameMode->SelectedUnit || TargetIndex < 0 || TargetIndex >= GetNumCells()) return;
 
-    // calcola il path con A*
-    TArray<FVector2D> Path = AStarPathfind(
-        GameMode->SelectedUnit->GetGridPosition(),
-        TargetCell->GetGridPosition(),
-        GameMode->SelectedUnit->MovementRange
-    );
+    const TWeakObjectPtr<AUnit> WeakUnit(GameMode->SelectedUnit);
+    const FIntPoint TargetCoord = GetCellCoord(TargetIndex);
+    const FVector2D Target(TargetCoord.X, TargetCoord.Y);
+    const FVector2D Origin = GameMode->SelectedUnit->GetGridPosition();
+    const int32 Range = GameMode->SelectedUnit->MovementRange;
 
-    // verifica che il path sia valido
-    if (Path.Num() > 0 && Path.Last() == TargetCell->GetGridPosition())
+    // di solito la raggiungibilità è già in cache dall'highlight; altrimenti arriva dal worker
+    RequestReachability(Origin, Range, [this, WeakUnit, TargetCoord, Target, Origin, Range](const FGridReachability&)
     {
-        if (GameMode->UnitActions->MoveUnit(GameMode->SelectedUnit, TargetCell->GetGridPosition()))
+        AUnit* Unit = WeakUnit.Get();
+
+        // selezione cambiata o unità già mossa nel frattempo
+        if (!Unit || !GameMode || GameMode->SelectedUnit != Unit || Unit->GetGridPosition() != Origin) return;
+
+        if (IsReachableWithin(Origin, Target, Range))
         {
-            TargetCell->SetHighlightColor(FLinearColor::Blue);
-            GameMode->SelectedUnit->SetSelected(false);
-            GameMode->SelectedUnit = nullptr;
-            GameMode->bWaitingForMoveTarget = false;
-            ClearHighlights();
-            GameMode->CheckTurnCompletion();
+            if (GameMode->UnitActions->MoveUnit(Unit, Target))
+            {
+                if (AGridCell* Cell = GetCellAt(TargetCoord.X, TargetCoord.Y))
+                {
+                    Cell->SetHighlightColor(FLinearColor::Blue);
+                }
+                Unit->SetSelected(false);
+                GameMode->SelectedUnit = nullptr;
+                GameMode->SetWaitingForMoveTarget(false);
+                ClearHighlights();
+                GameMode->CheckTurnCompletion();
+            }
         }
-    }
-    else
-    {
-        UE_LOG(LogTemp, Warning, TEXT("No valid path to target cell!"));
-    }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("No valid path to target cell!"));
+        }
+    });
 }
 
 void AGridManager::HandlePlayerAction(AGridCell* ClickedCell)
@@ -382,7 +835,7 @@ void AGridManager::HandlePlayerAction(AGridCell* ClickedCell)
         {
             GameMode->UnitActions->MoveUnit(GameMode->SelectedUnit, ClickedCell->GetGridPosition());
             ClearHighlights();
-            GameMode->bWaitingForMoveTarget = false;
+            GameMode->SetWaitingForMoveTarget(false);
         }
     }
 }
@@ -393,7 +846,7 @@ FString AGridManager::GetCellName(int32 X, int32 Y)
 }
 
 // Function to get world position of a grid cell
-FVector AGridManager::GetCellWorldPosition(int32 X, int32 Y)
+FVector AGridManager::GetCellWorldPosition(int32 X, int32 Y) const
 {
     return FVector(X * CellSize, Y * CellSize, 1.0f);
 }
@@ -409,11 +862,12 @@ bool AGridManager::FindRandomEmptyCell(int32& OutX, int32& OutY)
 
     // Collect all empty cells
     TArray<FVector2D> EmptyCells;
-    for (AGridCell* Cell : GridCells)
+    for (int32 Index = 0; Index < Board.NumCells(); Index++)
     {
-        if (IsValid(Cell) && !Cell->IsObstacle() && !Cell->IsOccupied())
+        if (!Board.IsBlocked(Index))
         {
-            EmptyCells.Add(FVector2D(Cell->GetGridPositionX(), Cell->GetGridPositionY()));
+            const FIntPoint Coord = GetCellCoord(Index);
+            EmptyCells.Add(FVector2D(Coord.X, Coord.Y));
         }
     }
 
@@ -425,7 +879,7 @@ bool AGridManager::FindRandomEmptyCell(int32& OutX, int32& OutY)
     }
 
     // Select a random empty cell
-    int32 RandomIndex = FMath::RandRange(0, EmptyCells.Num() - 1);
+    int32 RandomIndex = GetMatchRandomStream(this, EMatchRandomStream::Placement).RandRange(0, EmptyCells.Num() - 1);
     if (RandomIndex >= 0 && RandomIndex < EmptyCells.Num())
     {
         OutX = EmptyCells[RandomIndex].X;
@@ -444,18 +898,62 @@ AGridCell* AGridManager::GetCellAtPosition(FVector2D Position) const
     int32 X = FMath::RoundToInt(Position.X);
     int32 Y = FMath::RoundToInt(Position.Y);
 
-    if (X >= 0 && X < GridSizeX && Y >= 0 && Y < GridSizeY)
+    return GetCellAt(X, Y);
+}
+
+AGridCell* AGridManager::GetCellAt(int32 X, int32 Y) const
+{
+    if (!IsValidCoord(X, Y)) return nullptr;
+
+    const int32 Index = GetCellIndex(X, Y);
+    return GridCells.IsValidIndex(Index) ? GridCells[Index] : nullptr;
+}
+
+void AGridManager::ForEachCellInRect(int32 MinX, int32 MinY, int32 MaxX, int32 MaxY, TFunctionRef<void(int32 X, int32 Y, int32 Index)> Visitor) const
+{
+    // clamp al bordo della griglia, estremi inclusi
+    MinX = FMath::Max(MinX, 0);
+    MinY = FMath::Max(MinY, 0);
+    MaxX = FMath::Min(MaxX, GridSizeX - 1);
+    MaxY = FMath::Min(MaxY, GridSizeY - 1);
+
+    for (int32 X = MinX; X <= MaxX; X++)
     {
-        for (AGridCell* Cell : GridCells)
+        int32 Index = GetCellIndex(X, MinY);
+        for (int32 Y = MinY; Y <= MaxY; Y++, Index++)
         {
-            if (Cell && Cell->GetGridPositionX() == X && Cell->GetGridPositionY() == Y)
-            {
-                return Cell;
-            }
+            Visitor(X, Y, Index);
         }
     }
+}
 
-    return nullptr;
+void AGridManager::ForEachCellInDiamond(int32 CenterX, int32 CenterY, int32 Radius, TFunctionRef<void(int32 X, int32 Y, int32 Index)> Visitor) const
+{
+    // tutte le celle con distanza Manhattan <= Radius (centro incluso)
+    const int32 MinX = FMath::Max(CenterX - Radius, 0);
+    const int32 MaxX = FMath::Min(CenterX + Radius, GridSizeX - 1);
+
+    for (int32 X = MinX; X <= MaxX; X++)
+    {
+        const int32 Span = Radius - FMath::Abs(X - CenterX);
+        const int32 MinY = FMath::Max(CenterY - Span, 0);
+        const int32 MaxY = FMath::Min(CenterY + Span, GridSizeY - 1);
+
+        int32 Index = GetCellIndex(X, MinY);
+        for (int32 Y = MinY; Y <= MaxY; Y++, Index++)
+        {
+            Visitor(X, Y, Index);
+        }
+    }
+}
+
+void AGridManager::ForEachNeighbour(int32 X, int32 Y, TFunctionRef<void(int32 X, int32 Y, int32 Index)> Visitor) const
+{
+    // 4 vicini ortogonali, stesso ordine del vecchio array Directions
+    if (X + 1 < GridSizeX) Visitor(X + 1, Y, GetCellIndex(X + 1, Y));
+    if (X - 1 >= 0)        Visitor(X - 1, Y, GetCellIndex(X - 1, Y));
+    if (Y + 1 < GridSizeY) Visitor(X, Y + 1, GetCellIndex(X, Y + 1));
+    if (Y - 1 >= 0)        Visitor(X, Y - 1, GetCellIndex(X, Y - 1));
 }
 
 // Function to check if a cell is free
@@ -479,30 +977,28 @@ void AGridManager::HighlightMovementRange(FVector2D Center, int32 Range, bool bH
 
     CurrentlyHighlightedUnit = GameMode->SelectedUnit;
 
-    for (AGridCell* Cell : GridCells)
+    // una sola BFS limitata dall'unità, fuori dal game thread; si colora quando arriva
+    const uint32 Serial = HighlightSerial;
+    RequestReachability(Center, Range, [this, Serial](const FGridReachability& Reach)
     {
-        if (!Cell || Cell->IsObstacle() || Cell->IsOccupied()) continue;
-
-        FVector2D CellPos = Cell->GetGridPosition();
-        if (CellPos == Center) continue;
+        if (Serial != HighlightSerial) return;
 
-        // calcola il path usando A*
-        TArray<FVector2D> Path = AStarPathfind(Center, CellPos, Range);
-
-        // se la cella è raggiungibile e nel range
-        if (Path.Num() > 0 && Path.Last() == CellPos)
+        for (int32 Index : Reach.ReachedCells)
         {
-            HighlightCell(CellPos.X, CellPos.Y, true, false);
+            if (Index == Reach.OriginIndex) continue;
+
+            const FIntPoint Coord = GetCellCoord(Index);
+            HighlightCell(Coord.X, Coord.Y, true, false);
         }
-    }
+    });
 }
 
-void AGridManager::TryAttackSelectedUnit(AGridCell* TargetCell)
+void AGridManager::TryAttackSelectedUnit(int32 TargetIndex)
 {
-    if (!GameMode || !GameMode->SelectedUnit || !TargetCell) return;
+    if (!GameMode || !GameMode->SelectedUnit) return;
 
     AUnit* Attacker = GameMode->SelectedUnit;
-    AUnit* Target = TargetCell->GetUnit();
+    AUnit* Target = GetUnitAtIndex(TargetIndex);
 
     if (!Target)
     {
@@ -528,28 +1024,14 @@ void AGridManager::TryAttackSelectedUnit(AGridCell* TargetCell)
         return;
     }
 
-    // Attacco valido: calcola danno random
-    int32 Damage = FMath::RandRange(Attacker->MinDamage, Attacker->MaxDamage);
-    UE_LOG(LogTemp, Warning, TEXT("%s is attacking %s for %d damage"),
-        *Attacker->GetName(), *Target->GetName(), Damage);
-
-    Target->HP -= Damage;
-
-    if (Target->HP <= 0)
+    // danno, contrattacco e distruzione dalle stesse regole della simulazione
+    if (!GameMode->UnitActions || !GameMode->UnitActions->AttackUnit(Attacker, Target))
     {
-        UE_LOG(LogTemp, Warning, TEXT("%s has been destroyed!"), *Target->GetName());
-
-        // Rimuovi dalla cella
-        TargetCell->SetUnit(nullptr);
-        Target->DestroyUnit(); // già esistente nel tuo progetto
-    }
-    else
-    {
-        UE_LOG(LogTemp, Warning, TEXT("%s HP remaining: %d"), *Target->GetName(), Target->HP);
+        UE_LOG(LogTemp, Warning, TEXT("Attack not allowed!"));
+        return;
     }
 
     // Imposta flag per fine attacco
-    Attacker->bHasAttackedThisTurn = true;
     GameMode->bWaitingForAttackTarget = false;
     GameMode->SelectedUnit = nullptr;
     GameMode->CheckTurnCompletion();
@@ -637,34 +1119,73 @@ void AGridManager::HighlightAttackRange(FVector2D Center, int32 Range, bool bHig
 
     CurrentlyHighlightedUnit = Attacker;
 
-    for (AGridCell* Cell : GridCells)
-    {
-        if (!Cell) continue;
+    const int32 CenterX = FMath::RoundToInt(Center.X);
+    const int32 CenterY = FMath::RoundToInt(Center.Y);
 
-        FVector2D CellPos = Cell->GetGridPosition();
-        int32 Distance = FMath::Abs(CellPos.X - Center.X) + FMath::Abs(CellPos.Y - Center.Y);
+    // Reach nullo per il ranged, che non ha bisogno di percorsi
+    auto PaintTargets = [this, CenterX, CenterY, Range, Attacker](const FGridReachability* Reach)
+    {
+        // solo i nemici nel rombo Manhattan del range: niente scansione di celle
+        const int32 CenterIndex = GetCellIndex(CenterX, CenterY);
+        if (Reach)
+        {
+            UnitIndex.QueryRange(!Attacker->bIsPlayerUnit, CenterIndex, Range, UnitIdScratch);
+        }
+        else
+        {
+            // ranged: strato dei nemici AND rombo in cache, 64 celle per parola
+            FGridBitboard::GetTeamUnits(Board, !Attacker->bIsPlayerUnit, BitScratchA);
+            BitScratchA.AndWith(Bitboard.GetDiamond(CenterIndex, Range));
 
-        if (Distance == 0 || Distance > Range) continue;
+            UnitIdScratch.Reset();
+            BitScratchA.ForEachSetBit([this](int32 Index)
+            {
+                UnitIdScratch.Add(Board.GetUnitId(Index));
+            });
+        }
 
-        AUnit* Target = Cell->GetUnit();
+        for (const int32 TargetId : UnitIdScratch)
+        {
+            const int32 Index = UnitCellIndices[TargetId];
+            AUnit* Target = RegisteredUnits[TargetId];
+            if (!Target || Index == CenterIndex) continue;
 
-        // ignora celle vuote
-        if (!Target) continue;
+            const int32 X = Index / GridSizeY;
+            const int32 Y = Index % GridSizeY;
 
-        // ignora alleati
-        if (Target->bIsPlayerUnit == Attacker->bIsPlayerUnit) continue;
+            // check distanza melee: serve path fino a una cella adiacente al nemico
+            // (la cella del nemico è occupata, quindi non è mai raggiungibile essa stessa)
+            if (Reach)
+            {
+                bool bPathFound = false;
+                ForEachNeighbour(X, Y, [&](int32 NX, int32 NY, int32 NeighbourIndex)
+                {
+                    const int32 Distance = Reach->GetDistance(NeighbourIndex);
+                    bPathFound |= Distance != INDEX_NONE && Distance < Range;
+                });
+                if (!bPathFound) continue; // path bloccato
+            }
 
-        // check distanza melee: serve path
-        if (!bIsRangedAttack)
-        {
-            TArray<FVector2D> Path = AStarPathfind(Center, CellPos, Range);
-            if (Path.Num() == 0 || Path.Last() != CellPos) continue; // path bloccato
+            // evidenzia la cella con il nemico
+            HighlightCell(X, Y, true, true);
+            UE_LOG(LogTemp, Warning, TEXT("→ Highlight cell %s with enemy %s"), *GetCellName(X, Y), *Target->GetName());
         }
+    };
 
-        // evidenzia la cella con il nemico
-        HighlightCell(CellPos.X, CellPos.Y, true, true);
-        UE_LOG(LogTemp, Warning, TEXT("→ Highlight cell %s with enemy %s"), *Cell->GetCellName(), *Target->GetName());
+    if (bIsRangedAttack)
+    {
+        PaintTargets(nullptr);
+        return;
     }
+
+    // per il melee: celle calpestabili entro Range dal centro, calcolate su un worker
+    const uint32 Serial = HighlightSerial;
+    TWeakObjectPtr<AUnit> WeakAttacker(Attacker);
+    RequestReachability(Center, Range, [this, Serial, WeakAttacker, PaintTargets](const FGridReachability& Reach)
+    {
+        if (Serial != HighlightSerial || !WeakAttacker.IsValid()) return;
+        PaintTargets(&Reach);
+    });
 }
 
 
@@ -725,167 +1246,399 @@ void AGridManager::HighlightAttackRange(FVector2D Center, int32 Range, bool bHig
 
 TArray<FVector2D> AGridManager::AStarPathfind(FVector2D Start, FVector2D End, int32 MaxRange) const
 {
-    struct Node {
-        FVector2D Position;
-        int32 G; // Cost from start
-        int32 H; // Heuristic to end
-        int32 F() const { return G + H; }
-        TArray<FVector2D> Path;
+    return RunPathQuery(Start, End, MaxRange);
+}
 
-        Node(FVector2D Pos, int32 GVal, int32 HVal, const TArray<FVector2D>& PrevPath)
-            : Position(Pos), G(GVal), H(HVal), Path(PrevPath) 
-        {
-            Path.Add(Pos);
-        }
-    };
 
-    TArray<FVector2D> Result;
-    TArray<Node> Open;
-    TSet<FVector2D> Closed;
+TArray<FVector2D> AGridManager::FindPath(FVector2D Start, FVector2D End,  AUnit* MovingUnit)
+{
+    if (Start == End) return {};
 
-    Open.Add(Node(Start, 0, HeuristicCost(Start, End), {}));
+    // nessun limite di range
+    return RunPathQuery(Start, End, -1);
+}
+
+const FGridReachability& AGridManager::GetReachability(FVector2D Origin, int32 Range) const
+{
+    const int32 X = FMath::RoundToInt(Origin.X);
+    const int32 Y = FMath::RoundToInt(Origin.Y);
+    const int32 OriginIndex = IsValidCoord(X, Y) ? GetCellIndex(X, Y) : INDEX_NONE;
 
-    while (Open.Num() > 0)
+    if (const FGridReachability* Cached = FindCachedReachability(OriginIndex, Range))
     {
-        // Sort by lowest F cost
-        Open.Sort([](const Node& A, const Node& B) {
-            return A.F() < B.F();
-        });
+        return *Cached;
+    }
+    if (const FGridReachability* Repaired = RepairCachedReachability(OriginIndex, Range))
+    {
+        return *Repaired;
+    }
 
-        Node Current = Open[0];
-        Open.RemoveAt(0);
+    FGridReachability& Slot = AllocReachabilitySlot();
+    FGridPathfinder::ComputeReachability(Board, OriginIndex, Range, Slot);
+    return Slot;
+}
 
-        if (Current.Position == End)
+const FGridReachability* AGridManager::FindCachedReachability(int32 OriginIndex, int32 Range) const
+{
+    for (const FGridReachability& Cached : ReachabilityCache)
+    {
+        if (Cached.IsValid() && Cached.OriginIndex == OriginIndex && Cached.MaxCost == Range &&
+            Cached.BoardRevision == Board.Revision)
         {
-            return Current.Path;
+            return &Cached;
         }
+    }
+    return nullptr;
+}
 
-        Closed.Add(Current.Position);
+const FGridReachability* AGridManager::RepairCachedReachability(int32 OriginIndex, int32 Range) const
+{
+    for (FGridReachability& Cached : ReachabilityCache)
+    {
+        if (Cached.IsValid() && Cached.OriginIndex == OriginIndex && Cached.MaxCost == Range &&
+            BoardChanges.GetChangesSince(Cached.BoardRevision, ChangedCellsScratch))
+        {
+            Pathfinder.RepairReachability(Board, ChangedCellsScratch, Cached);
+            return &Cached;
+        }
+    }
+    return nullptr;
+}
 
-        // 4-direction movement only (no diagonals)
-        TArray<FVector2D> Directions = {
-            FVector2D(1,0), FVector2D(-1,0),
-            FVector2D(0,1), FVector2D(0,-1)
-        };
+FGridReachability& AGridManager::AllocReachabilitySlot() const
+{
+    FGridReachability& Slot = ReachabilityCache[NextReachabilitySlot];
+    NextReachabilitySlot = (NextReachabilitySlot + 1) % UE_ARRAY_COUNT(ReachabilityCache);
+    return Slot;
+}
 
-        for (const FVector2D& Dir : Directions)
-        {
-            FVector2D Neighbor = Current.Position + Dir;
+FGridBoardSnapshot AGridManager::GetBoardSnapshot() const
+{
+    if (!BoardSnapshot.IsValid() || BoardSnapshot->Revision != Board.Revision)
+    {
+        BoardSnapshot = MakeShared<FGridBoardState, ESPMode::ThreadSafe>(Board);
+    }
+    return BoardSnapshot.ToSharedRef();
+}
+
+FGridStaticDistancesSnapshot AGridManager::GetStaticDistancesSnapshot() const
+{
+    if (!StaticDistancesSnapshot.IsValid() && StaticDistances.Matches(Board))
+    {
+        StaticDistancesSnapshot = MakeShared<FGridStaticDistances, ESPMode::ThreadSafe>(StaticDistances);
+    }
+    return StaticDistancesSnapshot;
+}
 
-            // Check bounds
-            if (!IsValidCell(Neighbor)) continue;
-            
-            // Check if already evaluated
-            if (Closed.Contains(Neighbor)) continue;
+void AGridManager::RequestReachability(FVector2D Origin, int32 Range, TFunction<void(const FGridReachability&)> OnReady)
+{
+    const int32 X = FMath::RoundToInt(Origin.X);
+    const int32 Y = FMath::RoundToInt(Origin.Y);
+    const int32 OriginIndex = IsValidCoord(X, Y) ? GetCellIndex(X, Y) : INDEX_NONE;
 
-            // Check if cell is blocked (ignoring the moving unit)
-            if (IsCellBlocked(Neighbor.X, Neighbor.Y)) continue;
+    // già in cache, riparabile sul posto (costo proporzionale alle celle cambiate) o fuori griglia: niente worker
+    const FGridReachability* Cached = FindCachedReachability(OriginIndex, Range);
+    if (!Cached && OriginIndex != INDEX_NONE)
+    {
+        Cached = RepairCachedReachability(OriginIndex, Range);
+    }
+    if (Cached || OriginIndex == INDEX_NONE)
+    {
+        OnReady(Cached ? *Cached : GetReachability(Origin, Range));
+        return;
+    }
 
-            int32 NewG = Current.G + 1;
-            if (NewG > MaxRange) continue;
+    TWeakObjectPtr<AGridManager> WeakThis(this);
+    PathService.RequestReachability(GetBoardSnapshot(), OriginIndex, Range,
+        [WeakThis, Origin, Range, OnReady = MoveTemp(OnReady)](const FGridReachability& Result) mutable
+        {
+            AGridManager* Self = WeakThis.Get();
+            if (!Self) return;
 
-            // Check if this path is better
-            bool bFoundBetter = false;
-            for (Node& OpenNode : Open)
+            // la board è cambiata mentre il worker calcolava
+            if (Result.BoardRevision != Self->Board.Revision)
             {
-                if (OpenNode.Position == Neighbor && OpenNode.G <= NewG)
-                {
-                    bFoundBetter = true;
-                    break;
-                }
+                Self->RequestReachability(Origin, Range, MoveTemp(OnReady));
+                return;
             }
 
-            if (!bFoundBetter)
+            // richieste accodate alla stessa: solo la prima occupa uno slot
+            const FGridReachability* Stored = Self->FindCachedReachability(Result.OriginIndex, Result.MaxCost);
+            if (!Stored)
             {
-                int32 H = HeuristicCost(Neighbor, End);
-                Open.Add(Node(Neighbor, NewG, H, Current.Path));
+                FGridReachability& Slot = Self->AllocReachabilitySlot();
+                Slot = Result;
+                Stored = &Slot;
             }
-        }
-    }
-
-    return {}; // No path found
+            OnReady(*Stored);
+        });
 }
 
-
-TArray<FVector2D> AGridManager::FindPath(FVector2D Start, FVector2D End,  AUnit* MovingUnit)
+void AGridManager::RequestPath(FVector2D Start, FVector2D End, int32 MaxCost, TFunction<void(const TArray<FVector2D>&)> OnReady)
 {
-    TArray<FVector2D> Path;
+    const int32 StartX = FMath::RoundToInt(Start.X);
+    const int32 StartY = FMath::RoundToInt(Start.Y);
+    const int32 EndX = FMath::RoundToInt(End.X);
+    const int32 EndY = FMath::RoundToInt(End.Y);
+    if (!IsValidCoord(StartX, StartY) || !IsValidCoord(EndX, EndY))
+    {
+        OnReady(TArray<FVector2D>());
+        return;
+    }
+
+    TWeakObjectPtr<AGridManager> WeakThis(this);
+    PathService.SetBackend(PathBackend);
+    PathService.RequestPath(GetBoardSnapshot(), GetCellIndex(StartX, StartY), GetCellIndex(EndX, EndY), MaxCost,
+        [WeakThis, Start, End, MaxCost, OnReady = MoveTemp(OnReady)](const FGridPathResult& Result) mutable
+        {
+            AGridManager* Self = WeakThis.Get();
+            if (!Self) return;
 
-    if (Start == End) return Path;
+            if (Result.BoardRevision != Self->Board.Revision)
+            {
+                Self->RequestPath(Start, End, MaxCost, MoveTemp(OnReady));
+                return;
+            }
 
-    TArray<TTuple<float, FVector2D, TArray<FVector2D>>> OpenSet;
-    TSet<FVector2D> ClosedSet;
+            TArray<FVector2D> Path;
+            Path.Reserve(Result.Path.Num());
+            for (int32 Index : Result.Path)
+            {
+                const FIntPoint Coord = Self->GetCellCoord(Index);
+                Path.Add(FVector2D(Coord.X, Coord.Y));
+            }
+            OnReady(Path);
+        });
+}
 
-    TArray<FVector2D> InitialPath;
-    InitialPath.Add(Start);
-    OpenSet.Add(MakeTuple(HeuristicCost(Start, End), Start, InitialPath));
+void AGridManager::RunPathBenchmark()
+{
+    TArray<FGridPathBenchmarkResult> Results;
+    // seed fisso: stesse board e stesse query tra una run e l'altra
+    FGridPathBenchmark::RunDefaultSuite(1, Results);
+}
 
-    while (OpenSet.Num() > 0)
+void AGridManager::BuildStaticDistances()
+{
+    const double StartTime = FPlatformTime::Seconds();
+    StaticDistancesSnapshot.Reset();
+    if (!StaticDistances.Build(Board))
     {
-        OpenSet.Sort([](const auto& A, const auto& B) { return A.Get<0>() < B.Get<0>(); });
-        auto Current = OpenSet[0];
-        OpenSet.RemoveAt(0);
+        UE_LOG(LogTemp, Warning, TEXT("Static distance table skipped: %d cells exceed the limit of %d"),
+            GetNumCells(), FGridStaticDistances::MaxCells);
+        return;
+    }
 
-        FVector2D CurrentPos = Current.Get<1>();
-        TArray<FVector2D> CurrentPath = Current.Get<2>();
+    UE_LOG(LogTemp, Log, TEXT("Static distance table built for %d cells in %.2f ms"),
+        GetNumCells(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
 
-        if (CurrentPos == End)
+const FGridDistanceField& AGridManager::GetAttackDistanceField(bool bTargetPlayerTeam, int32 AttackRange, bool bRanged) const
+{
+    FAttackFieldCacheEntry* Entry = nullptr;
+    for (const TUniquePtr<FAttackFieldCacheEntry>& Candidate : AttackDistanceFields)
+    {
+        if (Candidate->bTargetPlayerTeam == bTargetPlayerTeam && Candidate->AttackRange == AttackRange && Candidate->bRanged == bRanged)
         {
-            Path = CurrentPath;
+            Entry = Candidate.Get();
             break;
         }
+    }
 
-        ClosedSet.Add(CurrentPos);
+    if (!Entry)
+    {
+        Entry = AttackDistanceFields.Add_GetRef(MakeUnique<FAttackFieldCacheEntry>()).Get();
+        Entry->bTargetPlayerTeam = bTargetPlayerTeam;
+        Entry->AttackRange = AttackRange;
+        Entry->bRanged = bRanged;
+    }
 
-        // 4-direction movement
-        TArray<FVector2D> Directions = { 
-            FVector2D(1,0), FVector2D(-1,0), 
-            FVector2D(0,1), FVector2D(0,-1) 
-        };
-        
-        for (FVector2D Dir : Directions)
+    FGridDistanceField& Field = Entry->Field;
+    if (Field.bBuilt && Field.BoardRevision == Board.Revision) return Field;
+
+    auto AddSources = [&]()
+    {
+        for (int32 UnitId = 0; UnitId < RegisteredUnits.Num(); UnitId++)
         {
-            FVector2D NextPos = CurrentPos + Dir;
+            const AUnit* Unit = RegisteredUnits[UnitId];
+            const int32 TargetIndex = UnitCellIndices.IsValidIndex(UnitId) ? UnitCellIndices[UnitId] : INDEX_NONE;
+            if (!Unit || Unit->bIsPlayerUnit != bTargetPlayerTeam || TargetIndex == INDEX_NONE) continue;
 
-            // Bounds checking
-            if (NextPos.X < 0 || NextPos.X >= GridSizeX || 
-                NextPos.Y < 0 || NextPos.Y >= GridSizeY)
-                continue;
+            // il corpo a corpo colpisce solo le celle adiacenti
+            const FIntPoint Target = GetCellCoord(TargetIndex);
+            ForEachCellInDiamond(Target.X, Target.Y, bRanged ? AttackRange : FMath::Min(AttackRange, 1), [&](int32 X, int32 Y, int32 Index)
+            {
+                if (Index != TargetIndex && !Board.IsObstacle(Index))
+                {
+                    Field.AddSource(Index, UnitId);
+                }
+            });
+        }
+    };
 
-            if (ClosedSet.Contains(NextPos)) continue;
+    if (Field.bBuilt && BoardChanges.GetChangesSince(Field.BoardRevision, ChangedCellsScratch))
+    {
+        Field.BeginRepair();
+        AddSources();
+        Field.Repair(Board, ChangedCellsScratch);
+        return Field;
+    }
 
-            // Use IsCellBlocked (no specific unit to ignore here)
-            if (IsCellBlocked(NextPos.X, NextPos.Y)) 
-                continue;
+    Field.Begin(Board);
+    AddSources();
 
-            TArray<FVector2D> NewPath = CurrentPath;
-            NewPath.Add(NextPos);
-            float NewCost = CurrentPath.Num() + HeuristicCost(NextPos, End);
+    // le celle d'attacco occupate valgono 0 solo per chi ci sta già sopra
+    Field.Propagate(Board, false);
+    return Field;
+}
 
-            OpenSet.Add(MakeTuple(NewCost, NextPos, NewPath));
-        }
+bool AGridManager::IsReachableWithin(FVector2D Origin, FVector2D Target, int32 Range) const
+{
+    const int32 X = FMath::RoundToInt(Target.X);
+    const int32 Y = FMath::RoundToInt(Target.Y);
+
+    // target non intero = nessuna cella
+    if (!IsValidCoord(X, Y) || Target != FVector2D(X, Y)) return false;
+
+    // troppo lontano anche senza unità in mezzo: una lettura al posto della BFS
+    const int32 OriginX = FMath::RoundToInt(Origin.X);
+    const int32 OriginY = FMath::RoundToInt(Origin.Y);
+    if (IsValidCoord(OriginX, OriginY) && StaticDistances.Matches(Board) &&
+        StaticDistances.Get(GetCellIndex(OriginX, OriginY), GetCellIndex(X, Y)) > Range)
+    {
+        return false;
     }
 
-    return Path;
+    return GetReachability(Origin, Range).IsReachable(GetCellIndex(X, Y));
 }
 
-
-void AGridManager::HighlightCell(int32 X, int32 Y, bool bHighlight, bool bIsAttackRange)
+TArray<FVector2D> AGridManager::RunPathQuery(FVector2D Start, FVector2D End, int32 MaxCost) const
 {
-    AGridCell* Cell = GetCellAtPosition(FVector2D(X, Y));
-    if (!Cell || !Cell->CellMesh) return;
+    TArray<FVector2D> Result;
+
+    const int32 StartX = FMath::RoundToInt(Start.X);
+    const int32 StartY = FMath::RoundToInt(Start.Y);
+    const int32 EndX = FMath::RoundToInt(End.X);
+    const int32 EndY = FMath::RoundToInt(End.Y);
+    if (!IsValidCoord(StartX, StartY) || !IsValidCoord(EndX, EndY)) return Result;
 
-    if (bHighlight)
+    const int32 StartIndex = GetCellIndex(StartX, StartY);
+    const int32 EndIndex = GetCellIndex(EndX, EndY);
+
+    Pathfinder.SetBackend(PathBackend);
+    bool bFound;
+    if (PathBackend == EGridPathBackend::Hierarchical && MaxCost < 0)
     {
-        UMaterialInterface* MaterialToUse = bIsAttackRange ? HighlightAttackMaterial : HighlightMoveMaterial;
-        Cell->CellMesh->SetMaterial(0, MaterialToUse);
-        Cell->SetHighlight(true);
+        // usa Pathfinder per le query corte e come ripiego
+        PathHierarchy.SetClusterSize(HierarchyClusterSize);
+        bFound = PathHierarchy.FindPath(Board, StartIndex, EndIndex, Pathfinder, PathScratch);
     }
     else
     {
-        // non serve riassegnare il materiale di default perché è già quello visibile di base
-        // quindi non facciamo nulla quicle
+        bFound = Pathfinder.FindPath(Board, StartIndex, EndIndex, MaxCost, PathScratch);
     }
+
+    if (!bFound)
+    {
+        return Result; // No path found
+    }
+
+    Result.Reserve(PathScratch.Num());
+    for (int32 Index : PathScratch)
+    {
+        const FIntPoint Coord = GetCellCoord(Index);
+        Result.Add(FVector2D(Coord.X, Coord.Y));
+    }
+    return Result;
+}
+
+
+void AGridManager::HighlightCell(int32 X, int32 Y, bool bHighlight, bool bIsAttackRange)
+{
+    if (!IsValidCoord(X, Y)) return;
+
+    const EGridHighlightKind Kind = !bHighlight ? EGridHighlightKind::None
+        : bIsAttackRange ? EGridHighlightKind::Attack : EGridHighlightKind::Move;
+    SetCellHighlight(GetCellIndex(X, Y), Kind);
+}
+
+void AGridManager::SetCellHighlight(int32 Index, EGridHighlightKind Kind)
+{
+    Highlights.Set(Index, Kind);
+    RequestHighlightFlush();
+}
+
+void AGridManager::RequestHighlightFlush()
+{
+    if (bHighlightFlushPending || !Highlights.HasPendingChanges() || !GetWorld()) return;
+
+    bHighlightFlushPending = true;
+    GetWorldTimerManager().SetTimerForNextTick(this, &AGridManager::FlushHighlights);
+}
+
+void AGridManager::FlushHighlights()
+{
+    bHighlightFlushPending = false;
+
+    if (CellInstances)
+    {
+        // solo custom data delle istanze cambiate, poi un unico aggiornamento del render state
+        const int32 NumChanged = Highlights.Flush([this](int32 Index, EGridHighlightKind Kind)
+        {
+            FLinearColor Color = HighlightMoveColor;
+            switch (Kind)
+            {
+            case EGridHighlightKind::Attack:      Color = HighlightAttackColor; break;
+            case EGridHighlightKind::PathPreview: Color = HighlightPathColor; break;
+            default: break;
+            }
+            const float Values[] = { Color.R, Color.G, Color.B, Kind != EGridHighlightKind::None ? 1.0f : 0.0f };
+            CellInstances->SetCustomData(Index, MakeArrayView(Values), false);
+        });
+        if (NumChanged > 0)
+        {
+            CellInstances->MarkRenderStateDirty();
+        }
+        return;
+    }
+
+    Highlights.Flush([this](int32 Index, EGridHighlightKind Kind)
+    {
+        AGridCell* Cell = GridCells.IsValidIndex(Index) ? GridCells[Index] : nullptr;
+        if (!Cell || !Cell->CellMesh) return;
+
+        // materiale condiviso: solo il colore nei custom data
+        if (Cell->UsesSharedMaterial())
+        {
+            switch (Kind)
+            {
+            case EGridHighlightKind::Attack:      Cell->SetHighlightColor(HighlightAttackColor); break;
+            case EGridHighlightKind::PathPreview: Cell->SetHighlightColor(HighlightPathColor); break;
+            case EGridHighlightKind::Move:        Cell->SetHighlightColor(HighlightMoveColor); break;
+            default:                              Cell->SetHighlight(false); break;
+            }
+            return;
+        }
+
+        UMaterialInterface* Material = nullptr;
+        switch (Kind)
+        {
+        case EGridHighlightKind::Attack:      Material = HighlightAttackMaterial; break;
+        case EGridHighlightKind::PathPreview: Material = HighlightPathMaterial ? HighlightPathMaterial : HighlightMoveMaterial; break;
+        case EGridHighlightKind::Move:        Material = HighlightMoveMaterial; break;
+        default: break;
+        }
+
+        // senza materiale configurato la cella usa il proprio
+        if (Kind != EGridHighlightKind::None && Material)
+        {
+            Cell->SetHighlightMaterial(Material);
+        }
+        else
+        {
+            Cell->SetHighlight(Kind != EGridHighlightKind::None);
+        }
+    });
 }
 
 bool AGridManager::IsValidCell(FVector2D Pos) const
@@ -901,14 +1654,17 @@ int32 AGridManager::HeuristicCost(FVector2D A, FVector2D B) const
 
 void AGridManager::ClearHighlights()
 {
-    for (AGridCell* Cell : GridCells)
-    {
-        if (!Cell || !Cell->CellMesh) continue;
-        
-        Cell->SetHighlight(false);
-    }
-    UE_LOG(LogTemp, Display, TEXT("ClearHighlights VEDERE SE VALE "));
+    // si spengono solo le celle accese, al prossimo tick: se nel frattempo arriva una nuova
+    // evidenziazione, le celle che restano accese non vengono toccate
+    Highlights.ClearAll();
+    RequestHighlightFlush();
+
+    // anche l'anteprima è spenta; se la scelta della destinazione continua si ridisegna al prossimo tick
+    HoverPath.Reset();
+    HoverCellIndex = INDEX_NONE;
+
     CurrentlyHighlightedUnit = nullptr;
+    HighlightSerial++;
 }
 
 
@@ -926,6 +1682,19 @@ void AGridManager::DestroyGrid()
         }
     }
     GridCells.Empty();
+    if (CellInstances)
+    {
+        CellInstances->ClearInstances();
+    }
+    if (ObstacleInstances)
+    {
+        ObstacleInstances->ClearInstances();
+        ObstacleInstanceOfCell.Reset();
+        ObstacleInstanceCells.Reset();
+        ObstacleInstanceShades.Reset();
+    }
+    StaticDistances.Reset();
+    StaticDistancesSnapshot.Reset();
 
     UE_LOG(LogTemp, Warning, TEXT("GridManager cleaned up!"));
 }
@@ -937,18 +1706,10 @@ FVector2D AGridCell::GetGridPosition() const
 
 bool AGridManager::IsCellBlocked(int32 X, int32 Y) const
 {
-    AGridCell* Cell = GetCellAtPosition(FVector2D(X, Y));
-    if (!Cell) return true;
-
-    if (Cell->IsObstacle()) return true;
-
-    // ogni cella occupata è bloccante
-    if (Cell->IsOccupied())
-    {
-        return true;
-    }
+    if (!IsValidCoord(X, Y)) return true;
 
-    return false;
+    // ostacolo o cella occupata: ogni cella occupata è bloccante
+    return Board.IsBlocked(GetCellIndex(X, Y));
 }
 
 bool AGridManager::IsPathBlocked(AGridCell* Start, AGridCell* End)
@@ -960,21 +1721,20 @@ bool AGridManager::IsPathBlocked(AGridCell* Start, AGridCell* End)
     FVector2D Dir = End->GetGridPosition() - Start->GetGridPosition();
     if (FMath::Abs(Dir.X) + FMath::Abs(Dir.Y) != 1) return true; // solo vicini ortogonali
 
-    return End->IsObstacle() || End->IsOccupied();
+    return Board.IsBlocked(GetCellIndex(End->GetGridPositionX(), End->GetGridPositionY()));
 }
 
 
 bool AGridManager::IsCellAttackable(int32 X, int32 Y, AUnit* Attacker) const
 {
-    AGridCell* Cell = GetCellAtPosition(FVector2D(X, Y));
-    if (!Cell) return false;
+    if (!IsValidCoord(X, Y) || !Attacker) return false;
 
     if (Attacker->AttackRange == 1)  // short-range (e.g., Brawler)
     {
         // can't attack over obstacles or empty cells
-        if (Cell->IsObstacle()) return false;
+        if (Board.IsObstacle(GetCellIndex(X, Y))) return false;
 
-        AUnit* Target = Cell->GetUnit();
+        AUnit* Target = GetUnitAt(X, Y);
         if (!Target || Target->bIsPlayerUnit == Attacker->bIsPlayerUnit)
         {
             return false; // no target or same team
@@ -983,7 +1743,7 @@ bool AGridManager::IsCellAttackable(int32 X, int32 Y, AUnit* Attacker) const
     }
     else // long-range (e.g., Sniper)
     {
-        AUnit* Target = Cell->GetUnit();
+        AUnit* Target = GetUnitAt(X, Y);
         if (!Target || Target->bIsPlayerUnit == Attacker->bIsPlayerUnit)
         {
             return false; // not an enemy
@@ -994,14 +1754,164 @@ bool AGridManager::IsCellAttackable(int32 X, int32 Y, AUnit* Attacker) const
 
 bool AGridManager::IsEnemyAtPosition(FVector2D Pos, bool bIsPlayer)
 {
-    if (AGridCell* Cell = GetCellAtPosition(Pos))
+    const int32 X = FMath::RoundToInt(Pos.X);
+    const int32 Y = FMath::RoundToInt(Pos.Y);
+    if (!IsValidCoord(X, Y)) return false;
+
+    // nemico se appartiene alla squadra opposta
+    return Board.HasEnemyAt(GetCellIndex(X, Y), bIsPlayer);
+}
+
+void AGridManager::SetCellObstacle(int32 X, int32 Y, bool bObstacle)
+{
+    if (!IsValidCoord(X, Y)) return;
+
+    const int32 Index = GetCellIndex(X, Y);
+    Board.SetObstacle(Index, bObstacle);
+    SyncCellView(Index);
+    NotifyCellChanged(Index);
+
+    // durante la generazione la tabella non esiste ancora
+    if (StaticDistances.IsBuilt())
+    {
+        StaticDistances.OnObstacleChanged(Board, Index);
+        StaticDistancesSnapshot.Reset(); // le ricerche in corso tengono la copia vecchia
+    }
+}
+
+void AGridManager::SetCellUnit(int32 X, int32 Y, AUnit* Unit)
+{
+    if (!IsValidCoord(X, Y)) return;
+
+    const int32 Index = GetCellIndex(X, Y);
+
+    // chi occupava la cella ne esce
+    const int32 PreviousId = Board.GetUnitId(Index);
+    if (PreviousId != INDEX_NONE)
+    {
+        UnitCellIndices[PreviousId] = INDEX_NONE;
+        UnitIndex.RemoveUnit(PreviousId);
+    }
+
+    if (Unit)
     {
-        if (AUnit* Unit = Cell->GetUnit())
+        const int32 UnitId = RegisterUnit(Unit);
+
+        // un'unità sta in una sola cella: libera quella vecchia
+        const int32 OldIndex = UnitCellIndices[UnitId];
+        if (OldIndex != INDEX_NONE && OldIndex != Index)
         {
-            return Unit->bIsPlayerUnit != bIsPlayer; // nemico se appartiene alla squadra opposta
+            Board.ClearUnit(OldIndex);
+            SyncCellView(OldIndex);
+            NotifyCellChanged(OldIndex);
         }
+
+        Board.SetUnit(Index, UnitId, Unit->bIsPlayerUnit);
+        UnitCellIndices[UnitId] = Index;
+        UnitIndex.SetUnit(UnitId, Index, Unit->bIsPlayerUnit);
     }
-    return false;
+    else
+    {
+        Board.ClearUnit(Index);
+    }
+    SyncCellView(Index);
+    NotifyCellChanged(Index);
+}
+
+void AGridManager::NotifyCellChanged(int32 Index)
+{
+    PathHierarchy.MarkCellChanged(Index);
+    BoardChanges.Record(Board, Index);
+}
+
+void AGridManager::SyncCellView(int32 Index)
+{
+    if (ObstacleInstances && ObstacleInstanceOfCell.IsValidIndex(Index))
+    {
+        if (Board.IsObstacle(Index))
+        {
+            AddObstacleInstance(Index);
+        }
+        else
+        {
+            RemoveObstacleInstance(Index);
+        }
+    }
+
+    if (CellInstances)
+    {
+        // l'occupazione non si vede sulla cella: si riscrive l'istanza solo se cambia l'ostacolo
+        // (e con ObstacleInstances la lastra resta com'è)
+        const bool bObstacle = Board.IsObstacle(Index);
+        if (ObstacleInstances || !CellInstances->IsValidInstance(Index) || InstancedObstacles.Get(Index) == bObstacle) return;
+
+        InstancedObstacles.Set(Index, bObstacle);
+        const float Shade = bObstacle ? GetMatchRandomStream(this, EMatchRandomStream::Cosmetic).FRandRange(0.3f, 1.0f) : 1.0f;
+        const FIntPoint Coord = GetCellCoord(Index);
+        CellInstances->SetCustomDataValue(Index, AGridCell::CustomDataObstacle, bObstacle ? 1.0f : 0.0f, false);
+        CellInstances->SetCustomDataValue(Index, AGridCell::CustomDataShade, Shade, false);
+        CellInstances->UpdateInstanceTransform(Index,
+            FTransform(FRotator::ZeroRotator, GetCellWorldPosition(Coord.X, Coord.Y), AGridCell::GetCellScale(bObstacle)), true, true, true);
+        return;
+    }
+
+    AGridCell* Cell = GridCells.IsValidIndex(Index) ? GridCells[Index] : nullptr;
+    if (!Cell) return;
+
+    Cell->SetObstacle(Board.IsObstacle(Index));
+    Cell->SetOccupied(Board.IsOccupied(Index));
+}
+
+int32 AGridManager::RegisterUnit(AUnit* Unit)
+{
+    if (!Unit) return INDEX_NONE;
+
+    if (Unit->UnitId == INDEX_NONE)
+    {
+        Unit->UnitId = RegisteredUnits.Add(Unit);
+        UnitCellIndices.Add(INDEX_NONE);
+    }
+    return Unit->UnitId;
+}
+
+void AGridManager::UnregisterUnit(AUnit* Unit)
+{
+    if (!Unit || !RegisteredUnits.IsValidIndex(Unit->UnitId)) return;
+
+    const int32 CellIndex = UnitCellIndices[Unit->UnitId];
+    if (CellIndex != INDEX_NONE)
+    {
+        Board.ClearUnit(CellIndex);
+        SyncCellView(CellIndex);
+        NotifyCellChanged(CellIndex);
+    }
+
+    // lo slot resta vuoto: gli id non vengono riciclati
+    UnitCellIndices[Unit->UnitId] = INDEX_NONE;
+    UnitIndex.RemoveUnit(Unit->UnitId);
+    RegisteredUnits[Unit->UnitId] = nullptr;
+}
+
+AUnit* AGridManager::GetUnitAt(int32 X, int32 Y) const
+{
+    return IsValidCoord(X, Y) ? GetUnitAtIndex(GetCellIndex(X, Y)) : nullptr;
+}
+
+AUnit* AGridManager::GetUnitAtIndex(int32 Index) const
+{
+    const int32 UnitId = Board.GetUnitId(Index);
+    return UnitId != INDEX_NONE ? RegisteredUnits[UnitId] : nullptr;
+}
+
+int32 AGridManager::GetUnitCellIndex(const AUnit* Unit) const
+{
+    if (!Unit || !UnitCellIndices.IsValidIndex(Unit->UnitId)) return INDEX_NONE;
+    return UnitCellIndices[Unit->UnitId];
+}
+
+AUnit* AGridManager::GetRegisteredUnit(int32 UnitId) const
+{
+    return RegisteredUnits.IsValidIndex(UnitId) ? RegisteredUnits[UnitId] : nullptr;
 }
 
 
@@ -0,0 +1,210 @@
+#include "GridPathBenchmark.h"
+#include "GridBoardState.h"
+#include "GridPathfinder.h"
+#include "GridPathHierarchy.h"
+#include "GridUnitIndex.h"
+#include "MatchRandom.h"
+
+namespace
+{
+	// stesse query su un indice che usa sempre i secchi e su uno che scorre sempre gli id
+	int32 CountUnitIndexMismatches(const FGridBoardState& Board, int32 NumUnits, const TArray<FIntPoint>& Queries, FPcg32& Random)
+	{
+		FGridUnitIndex Buckets;
+		FGridUnitIndex Linear;
+		Buckets.Init(Board.SizeX, Board.SizeY, FGridUnitIndex::DefaultBucketSize, 0);
+		Linear.Init(Board.SizeX, Board.SizeY, FGridUnitIndex::DefaultBucketSize, MAX_int32);
+
+		for (int32 Index = 0; Index < Board.NumCells(); Index++)
+		{
+			const int32 UnitId = Board.GetUnitId(Index);
+			if (UnitId == INDEX_NONE) continue;
+
+			Buckets.SetUnit(UnitId, Index, UnitId % 2 == 0);
+			Linear.SetUnit(UnitId, Index, UnitId % 2 == 0);
+		}
+
+		// qualche spostamento e rimozione, per passare anche dallo scollegamento nelle liste
+		for (int32 UnitId = 0; UnitId < NumUnits; UnitId += 7)
+		{
+			if (UnitId % 3 == 0)
+			{
+				Buckets.RemoveUnit(UnitId);
+				Linear.RemoveUnit(UnitId);
+				continue;
+			}
+
+			const int32 Cell = Random.RandRange(0, Board.NumCells() - 1);
+			Buckets.SetUnit(UnitId, Cell, UnitId % 2 == 0);
+			Linear.SetUnit(UnitId, Cell, UnitId % 2 == 0);
+		}
+
+		int32 Mismatches = 0;
+		TArray<int32> BucketIds;
+		TArray<int32> LinearIds;
+		for (int32 i = 0; i < Queries.Num(); i++)
+		{
+			const int32 Center = Queries[i].X;
+			const bool bPlayerTeam = i % 2 == 0;
+
+			const int32 Radius = Random.RandRange(0, 12);
+			Buckets.QueryRange(bPlayerTeam, Center, Radius, BucketIds);
+			Linear.QueryRange(bPlayerTeam, Center, Radius, LinearIds);
+			Mismatches += BucketIds != LinearIds;
+
+			const int32 K = Random.RandRange(1, 8);
+			Buckets.FindNearest(bPlayerTeam, Center, K, BucketIds);
+			Linear.FindNearest(bPlayerTeam, Center, K, LinearIds);
+			Mismatches += BucketIds != LinearIds;
+
+			// mai sotto Manhattan, con pareggi frequenti per provare l'ordine di spareggio
+			auto Distance = [&Board, Center](int32 Id, int32 Cell)
+			{
+				return Board.GetDistance(Center, Cell) + Id % 3;
+			};
+			int32 BucketDistance = INDEX_NONE;
+			int32 LinearDistance = INDEX_NONE;
+			const int32 BucketId = Buckets.FindNearestBy(bPlayerTeam, Center, Distance, &BucketDistance);
+			const int32 LinearId = Linear.FindNearestBy(bPlayerTeam, Center, Distance, &LinearDistance);
+			Mismatches += BucketId != LinearId || BucketDistance != LinearDistance;
+		}
+		return Mismatches;
+	}
+}
+
+FGridPathBenchmarkResult FGridPathBenchmark::Run(int32 Size, float ObstacleProbability, int32 NumQueries, uint64 Seed)
+{
+	FGridPathBenchmarkResult Result;
+	Result.Size = Size;
+	Result.ObstacleProbability = ObstacleProbability;
+
+	FPcg32 Random(Seed, static_cast<uint64>(Size));
+
+	FGridBoardState Board;
+	Board.Init(Size, Size);
+	TArray<int32> FreeCells;
+	int32 NumUnits = 0;
+	for (int32 Index = 0; Index < Board.NumCells(); Index++)
+	{
+		const float Roll = Random.FRand();
+		if (Roll < ObstacleProbability)
+		{
+			Board.SetObstacle(Index, true);
+		}
+		else if (Roll < ObstacleProbability + UnitProbability)
+		{
+			// le unità bloccano come gli ostacoli, ma JPS le legge dal layer di occupazione
+			Board.SetUnit(Index, NumUnits, NumUnits % 2 == 0);
+			NumUnits++;
+		}
+		else
+		{
+			FreeCells.Add(Index);
+		}
+	}
+	if (FreeCells.Num() < 2) return Result;
+
+	// stesse coppie per entrambi i backend
+	TArray<FIntPoint> Queries;
+	Queries.SetNumUninitialized(NumQueries);
+	for (FIntPoint& Query : Queries)
+	{
+		Query.X = FreeCells[Random.RandRange(0, FreeCells.Num() - 1)];
+		Query.Y = FreeCells[Random.RandRange(0, FreeCells.Num() - 1)];
+	}
+
+	FGridPathfinder AStar;
+	FGridPathfinder JumpPoint;
+	JumpPoint.SetBackend(EGridPathBackend::JumpPoint);
+
+	TArray<int32> AStarLengths;
+	AStarLengths.SetNumUninitialized(NumQueries);
+	TArray<int32> Path;
+
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumQueries; i++)
+	{
+		AStarLengths[i] = AStar.FindPath(Board, Queries[i].X, Queries[i].Y, -1, Path) ? Path.Num() : INDEX_NONE;
+		Result.AStarExpanded += AStar.GetLastExpandedCount();
+	}
+	Result.AStarMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumQueries; i++)
+	{
+		const int32 Length = JumpPoint.FindPath(Board, Queries[i].X, Queries[i].Y, -1, Path) ? Path.Num() : INDEX_NONE;
+		Result.JumpPointExpanded += JumpPoint.GetLastExpandedCount();
+
+		Result.NumFound += Length != INDEX_NONE;
+		Result.NumMismatches += Length != AStarLengths[i];
+	}
+	Result.JumpPointMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	FGridPathHierarchy Hierarchy;
+	StartTime = FPlatformTime::Seconds();
+	Hierarchy.Refresh(Board);
+	Result.HierarchicalBuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumQueries; i++)
+	{
+		const int32 Length = Hierarchy.FindPath(Board, Queries[i].X, Queries[i].Y, AStar, Path) ? Path.Num() : INDEX_NONE;
+		Result.HierarchicalExpanded += Hierarchy.WasLastQueryHierarchical() ? Hierarchy.GetLastExpandedCount() : AStar.GetLastExpandedCount();
+
+		if ((Length == INDEX_NONE) != (AStarLengths[i] == INDEX_NONE))
+		{
+			Result.NumHierarchicalMismatches++;
+		}
+		else if (Length != INDEX_NONE)
+		{
+			Result.HierarchicalExtraSteps += Length - AStarLengths[i];
+		}
+	}
+	Result.HierarchicalMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	Result.NumUnits = NumUnits;
+	Result.NumUnitIndexMismatches = CountUnitIndexMismatches(Board, NumUnits, Queries, Random);
+
+	Result.NumQueries = NumQueries;
+	return Result;
+}
+
+void FGridPathBenchmark::RunDefaultSuite(uint64 Seed, TArray<FGridPathBenchmarkResult>& OutResults)
+{
+	struct FConfig
+	{
+		int32 Size;
+		int32 NumQueries;
+	};
+	static const FConfig Configs[] = { { 25, 2000 }, { 100, 500 }, { 500, 40 } };
+	static const float Probabilities[] = { 0.05f, 0.15f, 0.30f };
+
+	OutResults.Reset();
+	for (const FConfig& Config : Configs)
+	{
+		for (float Probability : Probabilities)
+		{
+			const FGridPathBenchmarkResult& Result = OutResults.Add_GetRef(Run(Config.Size, Probability, Config.NumQueries, Seed));
+
+			UE_LOG(LogTemp, Log, TEXT("Path benchmark %dx%d p=%.2f: %d/%d found, A* %.2f ms (%lld expanded), JPS %.2f ms (%lld expanded), mismatches %d"),
+				Result.Size, Result.Size, Result.ObstacleProbability, Result.NumFound, Result.NumQueries,
+				Result.AStarMs, Result.AStarExpanded, Result.JumpPointMs, Result.JumpPointExpanded, Result.NumMismatches);
+
+			UE_LOG(LogTemp, Log, TEXT("Path benchmark %dx%d p=%.2f: HPA* build %.2f ms, queries %.2f ms (%lld expanded), %lld extra steps"),
+				Result.Size, Result.Size, Result.ObstacleProbability, Result.HierarchicalBuildMs, Result.HierarchicalMs,
+				Result.HierarchicalExpanded, Result.HierarchicalExtraSteps);
+
+			if (Result.NumMismatches > 0 || Result.NumHierarchicalMismatches > 0)
+			{
+				UE_LOG(LogTemp, Error, TEXT("Path benchmark: JPS disagrees with A* on %d queries, HPA* on %d"),
+					Result.NumMismatches, Result.NumHierarchicalMismatches);
+			}
+
+			if (Result.NumUnitIndexMismatches > 0)
+			{
+				UE_LOG(LogTemp, Error, TEXT("Path benchmark %dx%d: unit index buckets disagree with the linear scan on %d queries (%d units)"),
+					Result.Size, Result.Size, Result.NumUnitIndexMismatches, Result.NumUnits);
+			}
+		}
+	}
+}
@@ -0,0 +1,486 @@
+#include "GridPathHierarchy.h"
+#include "GridPathfinder.h"
+
+FGridPathHierarchy::FGridPathHierarchy(int32 InClusterSize)
+	: ClusterSize(FMath::Max(InClusterSize, 2))
+{
+}
+
+void FGridPathHierarchy::SetClusterSize(int32 InClusterSize)
+{
+	InClusterSize = FMath::Max(InClusterSize, 2);
+	if (InClusterSize == ClusterSize) return;
+
+	ClusterSize = InClusterSize;
+
+	// la prossima Refresh reinizializza tutto
+	SizeX = 0;
+	SizeY = 0;
+}
+
+void FGridPathHierarchy::Init(const FGridBoardState& Board)
+{
+	SizeX = Board.SizeX;
+	SizeY = Board.SizeY;
+	NumClustersX = FMath::DivideAndRoundUp(SizeX, ClusterSize);
+	NumClustersY = FMath::DivideAndRoundUp(SizeY, ClusterSize);
+
+	const int32 NumCells = Board.NumCells();
+	Clusters.Reset();
+	Clusters.SetNum(NumClustersX * NumClustersY);
+	BordersX.Reset();
+	BordersX.SetNum(FMath::Max(NumClustersX - 1, 0) * NumClustersY);
+	BordersY.Reset();
+	BordersY.SetNum(NumClustersX * FMath::Max(NumClustersY - 1, 0));
+
+	NodeSlot.Init(INDEX_NONE, NumCells);
+
+	LocalStamp.Init(0, NumCells);
+	LocalDistance.SetNumUninitialized(NumCells);
+	LocalParent.SetNumUninitialized(NumCells);
+	LocalGeneration = 0;
+
+	SeenStamp.Init(0, NumCells);
+	ClosedStamp.Init(0, NumCells);
+	GScore.SetNumUninitialized(NumCells);
+	Parent.SetNumUninitialized(NumCells);
+	Generation = 0;
+
+	DirtyClusters.Reset();
+	DirtyBordersX.Reset();
+	DirtyBordersY.Reset();
+	for (int32 i = 0; i < Clusters.Num(); i++) DirtyClusters.Add(i);
+	for (int32 i = 0; i < BordersX.Num(); i++) DirtyBordersX.Add(i);
+	for (int32 i = 0; i < BordersY.Num(); i++) DirtyBordersY.Add(i);
+}
+
+void FGridPathHierarchy::MarkAllDirty()
+{
+	// alla prossima Refresh si riparte da zero
+	SizeX = 0;
+	SizeY = 0;
+}
+
+void FGridPathHierarchy::MarkClusterDirty(int32 ClusterX, int32 ClusterY)
+{
+	const int32 ClusterIndex = ClusterX * NumClustersY + ClusterY;
+	if (Clusters[ClusterIndex].bDirty) return;
+
+	Clusters[ClusterIndex].bDirty = true;
+	DirtyClusters.Add(ClusterIndex);
+}
+
+void FGridPathHierarchy::MarkBorderDirty(TArray<FBorder>& Borders, TArray<int32>& DirtyList, int32 BorderIndex)
+{
+	if (Borders[BorderIndex].bDirty) return;
+
+	Borders[BorderIndex].bDirty = true;
+	DirtyList.Add(BorderIndex);
+}
+
+void FGridPathHierarchy::MarkCellChanged(int32 Index)
+{
+	// non ancora costruita: la prima Refresh calcola tutto
+	if (SizeY == 0 || Index < 0 || Index >= SizeX * SizeY) return;
+
+	const int32 X = Index / SizeY;
+	const int32 Y = Index % SizeY;
+	const int32 CX = X / ClusterSize;
+	const int32 CY = Y / ClusterSize;
+	const int32 LocalX = X - CX * ClusterSize;
+	const int32 LocalY = Y - CY * ClusterSize;
+
+	MarkClusterDirty(CX, CY);
+
+	// una cella di bordo cambia gli ingressi, quindi anche il cluster dall'altra parte
+	if (LocalX == 0 && CX > 0)
+	{
+		MarkBorderDirty(BordersX, DirtyBordersX, (CX - 1) * NumClustersY + CY);
+		MarkClusterDirty(CX - 1, CY);
+	}
+	if (LocalX == ClusterSize - 1 && CX + 1 < NumClustersX)
+	{
+		MarkBorderDirty(BordersX, DirtyBordersX, CX * NumClustersY + CY);
+		MarkClusterDirty(CX + 1, CY);
+	}
+	if (LocalY == 0 && CY > 0)
+	{
+		MarkBorderDirty(BordersY, DirtyBordersY, CX * (NumClustersY - 1) + CY - 1);
+		MarkClusterDirty(CX, CY - 1);
+	}
+	if (LocalY == ClusterSize - 1 && CY + 1 < NumClustersY)
+	{
+		MarkBorderDirty(BordersY, DirtyBordersY, CX * (NumClustersY - 1) + CY);
+		MarkClusterDirty(CX, CY + 1);
+	}
+}
+
+void FGridPathHierarchy::Refresh(const FGridBoardState& Board)
+{
+	if (Board.SizeX != SizeX || Board.SizeY != SizeY)
+	{
+		Init(Board);
+	}
+
+	LastRebuiltClusters = DirtyClusters.Num();
+
+	// prima i bordi: i nodi di un cluster vengono dai suoi quattro bordi
+	for (int32 BorderIndex : DirtyBordersX) RebuildBorder(Board, true, BorderIndex);
+	for (int32 BorderIndex : DirtyBordersY) RebuildBorder(Board, false, BorderIndex);
+	for (int32 ClusterIndex : DirtyClusters) RebuildCluster(Board, ClusterIndex);
+
+	DirtyBordersX.Reset();
+	DirtyBordersY.Reset();
+	DirtyClusters.Reset();
+}
+
+void FGridPathHierarchy::RebuildBorder(const FGridBoardState& Board, bool bAlongX, int32 BorderIndex)
+{
+	FBorder& Border = bAlongX ? BordersX[BorderIndex] : BordersY[BorderIndex];
+	Border.bDirty = false;
+	Border.Entrances.Reset();
+
+	int32 Line;
+	int32 First;
+	int32 Last;
+	if (bAlongX)
+	{
+		const int32 CX = BorderIndex / NumClustersY;
+		const int32 CY = BorderIndex % NumClustersY;
+		Line = (CX + 1) * ClusterSize - 1;
+		First = CY * ClusterSize;
+		Last = FMath::Min(First + ClusterSize, SizeY);
+	}
+	else
+	{
+		const int32 CX = BorderIndex / (NumClustersY - 1);
+		const int32 CY = BorderIndex % (NumClustersY - 1);
+		Line = (CY + 1) * ClusterSize - 1;
+		First = CX * ClusterSize;
+		Last = FMath::Min(First + ClusterSize, SizeX);
+	}
+
+	// cella sul lato inferiore del bordo; quella superiore è a +SizeY (lungo X) o +1 (lungo Y)
+	const int32 Step = bAlongX ? SizeY : 1;
+	auto LowerCell = [&](int32 T) { return bAlongX ? Board.ToIndex(Line, T) : Board.ToIndex(T, Line); };
+
+	auto AddEntrance = [&](int32 T)
+	{
+		const int32 Lower = LowerCell(T);
+		Border.Entrances.Add(FIntPoint(Lower, Lower + Step));
+	};
+
+	// tratti liberi da entrambi i lati: stretti = un ingresso al centro, larghi = uno per estremo
+	int32 RunStart = INDEX_NONE;
+	for (int32 T = First; T <= Last; T++)
+	{
+		bool bOpen = false;
+		if (T < Last)
+		{
+			const int32 Lower = LowerCell(T);
+			bOpen = !Board.IsBlocked(Lower) && !Board.IsBlocked(Lower + Step);
+		}
+
+		if (bOpen)
+		{
+			if (RunStart == INDEX_NONE) RunStart = T;
+			continue;
+		}
+
+		if (RunStart != INDEX_NONE)
+		{
+			const int32 RunEnd = T - 1;
+			if (RunEnd - RunStart + 1 <= MaxSingleEntranceWidth)
+			{
+				AddEntrance((RunStart + RunEnd) / 2);
+			}
+			else
+			{
+				AddEntrance(RunStart);
+				AddEntrance(RunEnd);
+			}
+			RunStart = INDEX_NONE;
+		}
+	}
+}
+
+void FGridPathHierarchy::RebuildCluster(const FGridBoardState& Board, int32 ClusterIndex)
+{
+	FCluster& Cluster = Clusters[ClusterIndex];
+	Cluster.bDirty = false;
+
+	for (int32 Node : Cluster.Nodes)
+	{
+		NodeSlot[Node] = INDEX_NONE;
+	}
+	Cluster.Nodes.Reset();
+
+	auto AddNode = [this, &Cluster](int32 Cell)
+	{
+		// una cella d'angolo può essere ingresso su due bordi
+		if (NodeSlot[Cell] != INDEX_NONE) return;
+		NodeSlot[Cell] = Cluster.Nodes.Num();
+		Cluster.Nodes.Add(Cell);
+	};
+
+	const int32 CX = ClusterIndex / NumClustersY;
+	const int32 CY = ClusterIndex % NumClustersY;
+	if (CX > 0)                for (const FIntPoint& Entrance : BordersX[(CX - 1) * NumClustersY + CY].Entrances) AddNode(Entrance.Y);
+	if (CX + 1 < NumClustersX) for (const FIntPoint& Entrance : BordersX[CX * NumClustersY + CY].Entrances) AddNode(Entrance.X);
+	if (CY > 0)                for (const FIntPoint& Entrance : BordersY[CX * (NumClustersY - 1) + CY - 1].Entrances) AddNode(Entrance.Y);
+	if (CY + 1 < NumClustersY) for (const FIntPoint& Entrance : BordersY[CX * (NumClustersY - 1) + CY].Entrances) AddNode(Entrance.X);
+
+	// una BFS locale per nodo: distanze esatte restando dentro il cluster
+	const int32 NumNodes = Cluster.Nodes.Num();
+	Cluster.Costs.SetNumUninitialized(NumNodes * NumNodes);
+	for (int32 i = 0; i < NumNodes; i++)
+	{
+		SearchCluster(Board, ClusterIndex, Cluster.Nodes[i], INDEX_NONE);
+		for (int32 j = 0; j < NumNodes; j++)
+		{
+			const int32 Node = Cluster.Nodes[j];
+			Cluster.Costs[i * NumNodes + j] = IsLocallyReached(Node) ? LocalDistance[Node] : INDEX_NONE;
+		}
+	}
+}
+
+void FGridPathHierarchy::SearchCluster(const FGridBoardState& Board, int32 ClusterIndex, int32 From, int32 StopAt)
+{
+	LocalGeneration++;
+	if (LocalGeneration == 0)
+	{
+		FMemory::Memzero(LocalStamp.GetData(), LocalStamp.Num() * sizeof(uint32));
+		LocalGeneration = 1;
+	}
+
+	const int32 MinX = (ClusterIndex / NumClustersY) * ClusterSize;
+	const int32 MinY = (ClusterIndex % NumClustersY) * ClusterSize;
+	const int32 MaxX = FMath::Min(MinX + ClusterSize, SizeX) - 1;
+	const int32 MaxY = FMath::Min(MinY + ClusterSize, SizeY) - 1;
+
+	LocalStamp[From] = LocalGeneration;
+	LocalDistance[From] = 0;
+	LocalParent[From] = INDEX_NONE;
+	LocalQueue.Reset();
+	LocalQueue.Add(From);
+
+	for (int32 Head = 0; Head < LocalQueue.Num(); Head++)
+	{
+		const int32 Current = LocalQueue[Head];
+		if (Current == StopAt) return;
+
+		const int32 X = Current / SizeY;
+		const int32 Y = Current % SizeY;
+
+		int32 Neighbours[4];
+		int32 NumNeighbours = 0;
+		if (X < MaxX) Neighbours[NumNeighbours++] = Current + SizeY;
+		if (X > MinX) Neighbours[NumNeighbours++] = Current - SizeY;
+		if (Y < MaxY) Neighbours[NumNeighbours++] = Current + 1;
+		if (Y > MinY) Neighbours[NumNeighbours++] = Current - 1;
+
+		for (int32 i = 0; i < NumNeighbours; i++)
+		{
+			const int32 Next = Neighbours[i];
+			if (IsLocallyReached(Next) || Board.IsBlocked(Next)) continue;
+
+			LocalStamp[Next] = LocalGeneration;
+			LocalDistance[Next] = LocalDistance[Current] + 1;
+			LocalParent[Next] = Current;
+			LocalQueue.Add(Next);
+		}
+	}
+}
+
+int32 FGridPathHierarchy::GetNumNodes() const
+{
+	int32 NumNodes = 0;
+	for (const FCluster& Cluster : Clusters)
+	{
+		NumNodes += Cluster.Nodes.Num();
+	}
+	return NumNodes;
+}
+
+bool FGridPathHierarchy::FindPath(const FGridBoardState& Board, int32 StartIndex, int32 GoalIndex, FGridPathfinder& Fallback,
+	TArray<int32>& OutPath)
+{
+	OutPath.Reset();
+	bLastHierarchical = false;
+	LastExpanded = 0;
+
+	const int32 NumCells = Board.NumCells();
+	if (StartIndex < 0 || StartIndex >= NumCells || GoalIndex < 0 || GoalIndex >= NumCells) return false;
+
+	Refresh(Board);
+
+	const int32 StartCluster = GetClusterOf(StartIndex);
+	const int32 GoalCluster = GetClusterOf(GoalIndex);
+
+	// cluster uguali o vicini: la gerarchia non fa risparmiare nulla
+	if (FMath::Abs(StartCluster / NumClustersY - GoalCluster / NumClustersY) <= 1 &&
+		FMath::Abs(StartCluster % NumClustersY - GoalCluster % NumClustersY) <= 1)
+	{
+		return Fallback.FindPath(Board, StartIndex, GoalIndex, -1, OutPath);
+	}
+
+	if (Board.IsBlocked(GoalIndex)) return false;
+
+	// l'unità in partenza può bloccare un ingresso del suo cluster: in quel caso (raro) A* piatto
+	if (!SearchAbstract(Board, StartIndex, GoalIndex) || !Refine(Board, StartIndex, GoalIndex, OutPath))
+	{
+		return Fallback.FindPath(Board, StartIndex, GoalIndex, -1, OutPath);
+	}
+
+	bLastHierarchical = true;
+	return true;
+}
+
+bool FGridPathHierarchy::SearchAbstract(const FGridBoardState& Board, int32 StartIndex, int32 GoalIndex)
+{
+	const int32 StartCluster = GetClusterOf(StartIndex);
+	const int32 GoalCluster = GetClusterOf(GoalIndex);
+
+	// partenza e arrivo entrano nel grafo solo per questa query
+	StartLinks.Reset();
+	SearchCluster(Board, StartCluster, StartIndex, INDEX_NONE);
+	for (int32 Node : Clusters[StartCluster].Nodes)
+	{
+		if (IsLocallyReached(Node)) StartLinks.Add({ Node, LocalDistance[Node] });
+	}
+
+	GoalLinks.Reset();
+	SearchCluster(Board, GoalCluster, GoalIndex, INDEX_NONE);
+	for (int32 Node : Clusters[GoalCluster].Nodes)
+	{
+		if (IsLocallyReached(Node)) GoalLinks.Add({ Node, LocalDistance[Node] });
+	}
+	if (StartLinks.Num() == 0 || GoalLinks.Num() == 0) return false;
+
+	Generation++;
+	if (Generation == 0)
+	{
+		FMemory::Memzero(SeenStamp.GetData(), SeenStamp.Num() * sizeof(uint32));
+		FMemory::Memzero(ClosedStamp.GetData(), ClosedStamp.Num() * sizeof(uint32));
+		Generation = 1;
+	}
+	OpenHeap.Reset();
+
+	const int32 GoalX = GoalIndex / SizeY;
+	const int32 GoalY = GoalIndex % SizeY;
+
+	auto Relax = [&](int32 From, int32 Next, int32 NewG)
+	{
+		if (ClosedStamp[Next] == Generation) return;
+		if (SeenStamp[Next] == Generation && GScore[Next] <= NewG) return;
+
+		SeenStamp[Next] = Generation;
+		GScore[Next] = NewG;
+		Parent[Next] = From;
+		const int32 H = FMath::Abs(Next / SizeY - GoalX) + FMath::Abs(Next % SizeY - GoalY);
+		OpenHeap.HeapPush({ NewG + H, NewG, Next }, FOpenNodeLess());
+	};
+
+	SeenStamp[StartIndex] = Generation;
+	GScore[StartIndex] = 0;
+	Parent[StartIndex] = INDEX_NONE;
+	OpenHeap.HeapPush({ 0, 0, StartIndex }, FOpenNodeLess());
+
+	while (OpenHeap.Num() > 0)
+	{
+		FOpenNode Current;
+		OpenHeap.HeapPop(Current, FOpenNodeLess(), EAllowShrinking::No);
+
+		if (ClosedStamp[Current.Index] == Generation || Current.G != GScore[Current.Index]) continue;
+		if (Current.Index == GoalIndex) return true;
+
+		ClosedStamp[Current.Index] = Generation;
+		LastExpanded++;
+
+		const int32 Cell = Current.Index;
+		const int32 CellCluster = GetClusterOf(Cell);
+
+		if (Cell == StartIndex)
+		{
+			for (const FLink& Link : StartLinks) Relax(Cell, Link.Cell, Current.G + Link.Cost);
+		}
+		else
+		{
+			// archi interni: distanze precalcolate verso gli altri ingressi del cluster
+			const FCluster& Cluster = Clusters[CellCluster];
+			const int32 NumNodes = Cluster.Nodes.Num();
+			const int32 Slot = NodeSlot[Cell];
+			for (int32 j = 0; j < NumNodes; j++)
+			{
+				const int32 Cost = Cluster.Costs[Slot * NumNodes + j];
+				if (j != Slot && Cost != INDEX_NONE) Relax(Cell, Cluster.Nodes[j], Current.G + Cost);
+			}
+		}
+
+		if (CellCluster == GoalCluster)
+		{
+			for (const FLink& Link : GoalLinks)
+			{
+				if (Link.Cell == Cell) Relax(Cell, GoalIndex, Current.G + Link.Cost);
+			}
+		}
+
+		// archi tra cluster: ingresso adiacente dall'altra parte del bordo
+		const int32 X = Cell / SizeY;
+		const int32 Y = Cell % SizeY;
+		int32 Neighbours[4];
+		int32 NumNeighbours = 0;
+		if (X + 1 < SizeX) Neighbours[NumNeighbours++] = Cell + SizeY;
+		if (X > 0)         Neighbours[NumNeighbours++] = Cell - SizeY;
+		if (Y + 1 < SizeY) Neighbours[NumNeighbours++] = Cell + 1;
+		if (Y > 0)         Neighbours[NumNeighbours++] = Cell - 1;
+
+		for (int32 i = 0; i < NumNeighbours; i++)
+		{
+			const int32 Next = Neighbours[i];
+			if (NodeSlot[Next] != INDEX_NONE && GetClusterOf(Next) != CellCluster) Relax(Cell, Next, Current.G + 1);
+		}
+	}
+
+	return false;
+}
+
+bool FGridPathHierarchy::Refine(const FGridBoardState& Board, int32 StartIndex, int32 GoalIndex, TArray<int32>& OutPath)
+{
+	AbstractPath.Reset();
+	for (int32 Index = GoalIndex; Index != INDEX_NONE; Index = Parent[Index])
+	{
+		AbstractPath.Add(Index);
+	}
+
+	OutPath.Reset();
+	OutPath.Reserve(GScore[GoalIndex] + 1);
+	OutPath.Add(StartIndex);
+
+	// AbstractPath va dal goal alla partenza
+	for (int32 i = AbstractPath.Num() - 1; i > 0; i--)
+	{
+		const int32 From = AbstractPath[i];
+		const int32 To = AbstractPath[i - 1];
+		const int32 Cluster = GetClusterOf(From);
+
+		if (GetClusterOf(To) != Cluster)
+		{
+			OutPath.Add(To); // passo attraverso il bordo
+			continue;
+		}
+
+		SearchCluster(Board, Cluster, From, To);
+		if (!IsLocallyReached(To)) return false;
+
+		// celle dopo From fino a To, scritte a ritroso dai predecessori
+		OutPath.AddUninitialized(LocalDistance[To]);
+		int32 Write = OutPath.Num() - 1;
+		for (int32 Index = To; Index != From; Index = LocalParent[Index])
+		{
+			OutPath[Write--] = Index;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,162 @@
+#include "GridPathService.h"
+#include "Async/Async.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	enum class EPathRequestKind : uint8
+	{
+		Path,
+		Reachability
+	};
+
+	// lo snapshot è tenuto vivo dal worker finché la richiesta è in volo: il puntatore basta a identificarlo
+	struct FPathRequestKey
+	{
+		const FGridBoardState* Board = nullptr;
+		EPathRequestKind Kind = EPathRequestKind::Path;
+		EGridPathBackend Backend = EGridPathBackend::AStar;
+		int32 From = INDEX_NONE;
+		int32 To = INDEX_NONE;
+		int32 MaxCost = 0;
+
+		bool operator==(const FPathRequestKey& Other) const
+		{
+			return Board == Other.Board && Kind == Other.Kind && Backend == Other.Backend &&
+				From == Other.From && To == Other.To && MaxCost == Other.MaxCost;
+		}
+
+		friend uint32 GetTypeHash(const FPathRequestKey& Key)
+		{
+			uint32 Hash = GetTypeHash(Key.Board);
+			Hash = HashCombine(Hash, GetTypeHash(static_cast<uint8>(Key.Kind) | (static_cast<uint32>(Key.Backend) << 8)));
+			Hash = HashCombine(Hash, GetTypeHash(Key.From));
+			Hash = HashCombine(Hash, GetTypeHash(Key.To));
+			return HashCombine(Hash, GetTypeHash(Key.MaxCost));
+		}
+	};
+}
+
+struct FGridPathService::FState
+{
+	// solo game thread
+	bool bShutdown = false;
+	int32 NumCoalesced = 0;
+	TMap<FPathRequestKey, TArray<FPathCallback>> PathWaiters;
+	TMap<FPathRequestKey, TArray<FReachabilityCallback>> ReachabilityWaiters;
+
+	// pathfinder riusati dai worker: a regime nessuna allocazione per query
+	FCriticalSection PoolLock;
+	TArray<TUniquePtr<FGridPathfinder>> FreePathfinders;
+
+	TUniquePtr<FGridPathfinder> AcquirePathfinder()
+	{
+		FScopeLock Lock(&PoolLock);
+		return FreePathfinders.Num() > 0 ? FreePathfinders.Pop(EAllowShrinking::No) : MakeUnique<FGridPathfinder>();
+	}
+
+	void ReleasePathfinder(TUniquePtr<FGridPathfinder>&& Pathfinder)
+	{
+		FScopeLock Lock(&PoolLock);
+		FreePathfinders.Add(MoveTemp(Pathfinder));
+	}
+};
+
+FGridPathService::FGridPathService()
+	: State(MakeShared<FState, ESPMode::ThreadSafe>())
+{
+}
+
+FGridPathService::~FGridPathService()
+{
+	State->bShutdown = true;
+	State->PathWaiters.Empty();
+	State->ReachabilityWaiters.Empty();
+}
+
+int32 FGridPathService::GetNumInFlight() const
+{
+	return State->PathWaiters.Num() + State->ReachabilityWaiters.Num();
+}
+
+int32 FGridPathService::GetNumCoalesced() const
+{
+	return State->NumCoalesced;
+}
+
+void FGridPathService::RequestPath(const FGridBoardSnapshot& Board, int32 StartIndex, int32 GoalIndex, int32 MaxCost,
+	FPathCallback OnComplete)
+{
+	FPathRequestKey Key;
+	Key.Board = &Board.Get();
+	Key.Kind = EPathRequestKind::Path;
+	Key.Backend = Backend == EGridPathBackend::JumpPoint ? EGridPathBackend::JumpPoint : EGridPathBackend::AStar;
+	Key.From = StartIndex;
+	Key.To = GoalIndex;
+	Key.MaxCost = MaxCost;
+
+	if (TArray<FPathCallback>* Waiters = State->PathWaiters.Find(Key))
+	{
+		Waiters->Add(MoveTemp(OnComplete));
+		State->NumCoalesced++;
+		return;
+	}
+	State->PathWaiters.Add(Key).Add(MoveTemp(OnComplete));
+
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [SharedState = State, Board, Key]()
+	{
+		TSharedRef<FGridPathResult, ESPMode::ThreadSafe> Result = MakeShared<FGridPathResult, ESPMode::ThreadSafe>();
+		Result->BoardRevision = Board->Revision;
+
+		TUniquePtr<FGridPathfinder> Pathfinder = SharedState->AcquirePathfinder();
+		Pathfinder->SetBackend(Key.Backend);
+		Result->bFound = Pathfinder->FindPath(*Board, Key.From, Key.To, Key.MaxCost, Result->Path);
+		SharedState->ReleasePathfinder(MoveTemp(Pathfinder));
+
+		AsyncTask(ENamedThreads::GameThread, [SharedState, Key, Result]()
+		{
+			TArray<FPathCallback> Waiters;
+			if (SharedState->bShutdown || !SharedState->PathWaiters.RemoveAndCopyValue(Key, Waiters)) return;
+
+			for (FPathCallback& Callback : Waiters)
+			{
+				Callback(*Result);
+			}
+		});
+	});
+}
+
+void FGridPathService::RequestReachability(const FGridBoardSnapshot& Board, int32 OriginIndex, int32 MaxCost,
+	FReachabilityCallback OnComplete)
+{
+	FPathRequestKey Key;
+	Key.Board = &Board.Get();
+	Key.Kind = EPathRequestKind::Reachability;
+	Key.From = OriginIndex;
+	Key.MaxCost = MaxCost;
+
+	if (TArray<FReachabilityCallback>* Waiters = State->ReachabilityWaiters.Find(Key))
+	{
+		Waiters->Add(MoveTemp(OnComplete));
+		State->NumCoalesced++;
+		return;
+	}
+	State->ReachabilityWaiters.Add(Key).Add(MoveTemp(OnComplete));
+
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [SharedState = State, Board, Key]()
+	{
+		TSharedRef<FGridReachability, ESPMode::ThreadSafe> Result = MakeShared<FGridReachability, ESPMode::ThreadSafe>();
+		FGridPathfinder::ComputeReachability(*Board, Key.From, Key.MaxCost, *Result);
+
+		AsyncTask(ENamedThreads::GameThread, [SharedState, Key, Result]()
+		{
+			TArray<FReachabilityCallback> Waiters;
+			if (SharedState->bShutdown || !SharedState->ReachabilityWaiters.RemoveAndCopyValue(Key, Waiters)) return;
+
+			for (FReachabilityCallback& Callback : Waiters)
+			{
+				Callback(*Result);
+			}
+		});
+	});
+}
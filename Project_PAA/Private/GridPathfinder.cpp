@@ -0,0 +1,555 @@
+#include "GridPathfinder.h"
+#include "GridStaticDistances.h"
+
+void FGridPathfinder::BeginQuery(int32 NumCells)
+{
+	if (SeenStamp.Num() != NumCells)
+	{
+		// cambio dimensione griglia: unica (ri)allocazione
+		SeenStamp.Init(0, NumCells);
+		ClosedStamp.Init(0, NumCells);
+		GScore.SetNumUninitialized(NumCells);
+		Parent.SetNumUninitialized(NumCells);
+		Generation = 0;
+	}
+
+	Generation++;
+	if (Generation == 0)
+	{
+		// overflow del timbro: azzera e riparti
+		FMemory::Memzero(SeenStamp.GetData(), SeenStamp.Num() * sizeof(uint32));
+		FMemory::Memzero(ClosedStamp.GetData(), ClosedStamp.Num() * sizeof(uint32));
+		Generation = 1;
+	}
+
+	OpenHeap.Reset();
+	LastExpanded = 0;
+}
+
+bool FGridPathfinder::FindPath(const FGridBoardState& Board, int32 StartIndex, int32 GoalIndex, int32 MaxCost, TArray<int32>& OutPath)
+{
+	OutPath.Reset();
+
+	const int32 NumCells = Board.NumCells();
+	if (StartIndex < 0 || StartIndex >= NumCells || GoalIndex < 0 || GoalIndex >= NumCells) return false;
+
+	const int32 CostLimit = MaxCost < 0 ? MAX_int32 : MaxCost;
+
+	// riga del goal (simmetrica): la stessa fonte per tutti i nodi mantiene l'euristica consistente
+	const uint8* GoalRow = StaticDistances && StaticDistances->Matches(Board) ? StaticDistances->GetRow(GoalIndex) : nullptr;
+	if (GoalRow && (GoalRow[StartIndex] == FGridStaticDistances::Unreachable || GoalRow[StartIndex] > CostLimit))
+	{
+		LastExpanded = 0;
+		return false;
+	}
+
+	BeginQuery(NumCells);
+
+	if (Backend == EGridPathBackend::JumpPoint && MaxCost < 0)
+	{
+		return FindJumpPointPath(Board, StartIndex, GoalIndex, GoalRow, OutPath);
+	}
+
+	const int32 SizeY = Board.SizeY;
+	const int32 GoalX = GoalIndex / SizeY;
+	const int32 GoalY = GoalIndex % SizeY;
+
+	auto Heuristic = [SizeY, GoalX, GoalY, GoalRow](int32 Index)
+	{
+		if (GoalRow) return static_cast<int32>(GoalRow[Index]);
+		return FMath::Abs(Index / SizeY - GoalX) + FMath::Abs(Index % SizeY - GoalY); // distanza Manhattan
+	};
+
+	SeenStamp[StartIndex] = Generation;
+	GScore[StartIndex] = 0;
+	Parent[StartIndex] = INDEX_NONE;
+	OpenHeap.HeapPush({ Heuristic(StartIndex), 0, StartIndex }, FOpenNodeLess());
+
+	while (OpenHeap.Num() > 0)
+	{
+		FOpenNode Current;
+		OpenHeap.HeapPop(Current, FOpenNodeLess(), EAllowShrinking::No);
+
+		// voce superata da un G migliore (lazy deletion)
+		if (IsClosed(Current.Index) || Current.G != GScore[Current.Index]) continue;
+
+		if (Current.Index == GoalIndex)
+		{
+			BuildPath(GoalIndex, OutPath);
+			return true;
+		}
+
+		ClosedStamp[Current.Index] = Generation;
+		LastExpanded++;
+
+		const int32 NewG = Current.G + 1;
+		if (NewG > CostLimit) continue;
+
+		const int32 X = Current.Index / SizeY;
+		const int32 Y = Current.Index % SizeY;
+
+		// 4 vicini ortogonali, nessuna diagonale
+		int32 Neighbours[4];
+		int32 NumNeighbours = 0;
+		if (X + 1 < Board.SizeX) Neighbours[NumNeighbours++] = Current.Index + SizeY;
+		if (X > 0)               Neighbours[NumNeighbours++] = Current.Index - SizeY;
+		if (Y + 1 < SizeY)       Neighbours[NumNeighbours++] = Current.Index + 1;
+		if (Y > 0)               Neighbours[NumNeighbours++] = Current.Index - 1;
+
+		for (int32 i = 0; i < NumNeighbours; i++)
+		{
+			const int32 Next = Neighbours[i];
+			if (IsClosed(Next) || Board.IsBlocked(Next)) continue;
+			if (IsSeen(Next) && GScore[Next] <= NewG) continue;
+
+			SeenStamp[Next] = Generation;
+			GScore[Next] = NewG;
+			Parent[Next] = Current.Index;
+			OpenHeap.HeapPush({ NewG + Heuristic(Next), NewG, Next }, FOpenNodeLess());
+		}
+	}
+
+	return false; // No path found
+}
+
+// Jump Point Search su griglia 4-connessa, ordine canonico "prima lungo X, poi lungo Y":
+// - un passo lungo X è jump point se da lì una scansione lungo Y trova qualcosa;
+// - un passo lungo Y è jump point se una cella accanto diventa libera dopo essere stata bloccata
+//   una riga prima (vicino forzato): lì il percorso canonico è costretto a girare.
+// Ogni segmento tra jump point è rettilineo, quindi G = G del parent + distanza Manhattan.
+bool FGridPathfinder::FindJumpPointPath(const FGridBoardState& Board, int32 StartIndex, int32 GoalIndex, const uint8* GoalRow,
+	TArray<int32>& OutPath)
+{
+	const int32 SizeY = Board.SizeY;
+	const int32 GoalX = GoalIndex / SizeY;
+	const int32 GoalY = GoalIndex % SizeY;
+
+	auto Heuristic = [SizeY, GoalX, GoalY, GoalRow](int32 Index)
+	{
+		if (GoalRow) return static_cast<int32>(GoalRow[Index]);
+		return FMath::Abs(Index / SizeY - GoalX) + FMath::Abs(Index % SizeY - GoalY); // distanza Manhattan
+	};
+
+	auto TryJump = [this, SizeY, &Heuristic](int32 From, int32 G, int32 JumpIndex)
+	{
+		if (JumpIndex == INDEX_NONE || IsClosed(JumpIndex)) return;
+
+		const int32 NewG = G + FMath::Abs(JumpIndex / SizeY - From / SizeY) + FMath::Abs(JumpIndex % SizeY - From % SizeY);
+		if (IsSeen(JumpIndex) && GScore[JumpIndex] <= NewG) return;
+
+		SeenStamp[JumpIndex] = Generation;
+		GScore[JumpIndex] = NewG;
+		Parent[JumpIndex] = From;
+		OpenHeap.HeapPush({ NewG + Heuristic(JumpIndex), NewG, JumpIndex }, FOpenNodeLess());
+	};
+
+	SeenStamp[StartIndex] = Generation;
+	GScore[StartIndex] = 0;
+	Parent[StartIndex] = INDEX_NONE;
+	OpenHeap.HeapPush({ Heuristic(StartIndex), 0, StartIndex }, FOpenNodeLess());
+
+	while (OpenHeap.Num() > 0)
+	{
+		FOpenNode Current;
+		OpenHeap.HeapPop(Current, FOpenNodeLess(), EAllowShrinking::No);
+
+		if (IsClosed(Current.Index) || Current.G != GScore[Current.Index]) continue;
+
+		if (Current.Index == GoalIndex)
+		{
+			BuildJumpPointPath(SizeY, GoalIndex, OutPath);
+			return true;
+		}
+
+		ClosedStamp[Current.Index] = Generation;
+		LastExpanded++;
+
+		const int32 X = Current.Index / SizeY;
+		const int32 Y = Current.Index % SizeY;
+		const int32 ParentIndex = Parent[Current.Index];
+
+		if (ParentIndex == INDEX_NONE)
+		{
+			// partenza: tutte e quattro le direzioni
+			TryJump(Current.Index, Current.G, JumpX(Board, X, Y, 1, GoalIndex));
+			TryJump(Current.Index, Current.G, JumpX(Board, X, Y, -1, GoalIndex));
+			TryJump(Current.Index, Current.G, JumpY(Board, X, Y, 1, GoalIndex));
+			TryJump(Current.Index, Current.G, JumpY(Board, X, Y, -1, GoalIndex));
+			continue;
+		}
+
+		const int32 DX = FMath::Sign(X - ParentIndex / SizeY);
+		const int32 DY = FMath::Sign(Y - ParentIndex % SizeY);
+
+		if (DX != 0)
+		{
+			// lungo X proseguire e girare lungo Y sono entrambi naturali
+			TryJump(Current.Index, Current.G, JumpX(Board, X, Y, DX, GoalIndex));
+			TryJump(Current.Index, Current.G, JumpY(Board, X, Y, 1, GoalIndex));
+			TryJump(Current.Index, Current.G, JumpY(Board, X, Y, -1, GoalIndex));
+		}
+		else
+		{
+			// lungo Y si gira solo verso i vicini forzati
+			TryJump(Current.Index, Current.G, JumpY(Board, X, Y, DY, GoalIndex));
+			if (IsForced(Board, X - 1, Y, DY)) TryJump(Current.Index, Current.G, JumpX(Board, X, Y, -1, GoalIndex));
+			if (IsForced(Board, X + 1, Y, DY)) TryJump(Current.Index, Current.G, JumpX(Board, X, Y, 1, GoalIndex));
+		}
+	}
+
+	return false; // No path found
+}
+
+bool FGridPathfinder::IsForced(const FGridBoardState& Board, int32 SideX, int32 Y, int32 DY)
+{
+	return IsFree(Board, SideX, Y) && !IsFree(Board, SideX, Y - DY);
+}
+
+int32 FGridPathfinder::JumpX(const FGridBoardState& Board, int32 X, int32 Y, int32 DX, int32 GoalIndex)
+{
+	for (;;)
+	{
+		X += DX;
+		if (!IsFree(Board, X, Y)) return INDEX_NONE;
+
+		const int32 Index = Board.ToIndex(X, Y);
+		if (Index == GoalIndex) return Index;
+
+		if (JumpY(Board, X, Y, 1, GoalIndex) != INDEX_NONE || JumpY(Board, X, Y, -1, GoalIndex) != INDEX_NONE) return Index;
+	}
+}
+
+uint64 FGridPathfinder::LoadBlockedBits(const FGridBoardState& Board, int32 X, int32 Y)
+{
+	// 64 celle consecutive lungo Y a partire da (X, Y): bit 0 = (X, Y)
+	const int32 Bit = Board.ToIndex(X, Y);
+	const int32 Word = Bit >> 6;
+	const int32 Shift = Bit & 63;
+	const int32 NumWords = Board.Obstacles.Words.Num();
+
+	uint64 Bits = (Board.Obstacles.Words[Word] | Board.Occupied.Words[Word]) >> Shift;
+	if (Shift != 0 && Word + 1 < NumWords)
+	{
+		Bits |= (Board.Obstacles.Words[Word + 1] | Board.Occupied.Words[Word + 1]) << (64 - Shift);
+	}
+	return Bits;
+}
+
+int32 FGridPathfinder::JumpY(const FGridBoardState& Board, int32 X, int32 Y, int32 DY, int32 GoalIndex)
+{
+	// le celle lungo Y sono bit contigui: 64 passi per volta invece di uno.
+	// Stops = celle con vicino forzato o goal; si ferma sulla prima prima di un blocco
+	const int32 SizeY = Board.SizeY;
+	const int32 GoalX = GoalIndex / SizeY;
+	const int32 GoalY = GoalIndex % SizeY;
+
+	if (DY > 0)
+	{
+		for (int32 Base = Y + 1; Base < SizeY; Base += 64)
+		{
+			const int32 Count = FMath::Min(64, SizeY - Base);
+			const uint64 Valid = Count == 64 ? ~0ull : (1ull << Count) - 1;
+
+			uint64 Stops = 0;
+			for (int32 SideX = X - 1; SideX <= X + 1; SideX += 2)
+			{
+				if (SideX < 0 || SideX >= Board.SizeX) continue;
+				// forzato in y: lato libero in y, bloccato in y - 1
+				Stops |= ~LoadBlockedBits(Board, SideX, Base) & LoadBlockedBits(Board, SideX, Base - 1);
+			}
+			if (GoalX == X && GoalY >= Base && GoalY < Base + Count) Stops |= 1ull << (GoalY - Base);
+
+			const uint64 Blocked = LoadBlockedBits(Board, X, Base) & Valid;
+			Stops &= Valid;
+
+			const int32 FirstBlocked = Blocked ? static_cast<int32>(FMath::CountTrailingZeros64(Blocked)) : 64;
+			const int32 FirstStop = Stops ? static_cast<int32>(FMath::CountTrailingZeros64(Stops)) : 64;
+			if (FirstStop < FirstBlocked) return Board.ToIndex(X, Base + FirstStop);
+			if (Blocked) return INDEX_NONE;
+		}
+		return INDEX_NONE;
+	}
+
+	for (int32 Top = Y - 1; Top >= 0; Top -= 64)
+	{
+		const int32 Base = FMath::Max(0, Top - 63);
+		const int32 Count = Top - Base + 1;
+		const uint64 Valid = Count == 64 ? ~0ull : (1ull << Count) - 1;
+
+		uint64 Stops = 0;
+		for (int32 SideX = X - 1; SideX <= X + 1; SideX += 2)
+		{
+			if (SideX < 0 || SideX >= Board.SizeX) continue;
+			// forzato in y: lato libero in y, bloccato in y + 1
+			Stops |= ~LoadBlockedBits(Board, SideX, Base) & LoadBlockedBits(Board, SideX, Base + 1);
+		}
+		if (GoalX == X && GoalY >= Base && GoalY <= Top) Stops |= 1ull << (GoalY - Base);
+
+		const uint64 Blocked = LoadBlockedBits(Board, X, Base) & Valid;
+		Stops &= Valid;
+
+		// scendendo conta il bit più alto
+		const int32 LastBlocked = Blocked ? 63 - static_cast<int32>(FMath::CountLeadingZeros64(Blocked)) : -1;
+		const int32 LastStop = Stops ? 63 - static_cast<int32>(FMath::CountLeadingZeros64(Stops)) : -1;
+		if (LastStop > LastBlocked) return Board.ToIndex(X, Base + LastStop);
+		if (Blocked) return INDEX_NONE;
+	}
+	return INDEX_NONE;
+}
+
+void FGridPathfinder::BuildJumpPointPath(int32 SizeY, int32 GoalIndex, TArray<int32>& OutPath) const
+{
+	// tra due jump point il segmento è rettilineo: si riempiono le celle intermedie
+	OutPath.SetNumUninitialized(GScore[GoalIndex] + 1, EAllowShrinking::No);
+	int32 Write = OutPath.Num() - 1;
+	int32 Index = GoalIndex;
+	for (; Parent[Index] != INDEX_NONE; Index = Parent[Index])
+	{
+		const int32 From = Parent[Index];
+		const int32 Step = (Index / SizeY != From / SizeY) ? FMath::Sign(From - Index) * SizeY : FMath::Sign(From - Index);
+		for (int32 Cell = Index; Cell != From; Cell += Step)
+		{
+			OutPath[Write--] = Cell;
+		}
+	}
+	OutPath[Write] = Index; // partenza
+}
+
+void FGridPathfinder::BuildPath(int32 GoalIndex, TArray<int32>& OutPath) const
+{
+	// ricostruzione solo alla fine, risalendo i parent
+	OutPath.SetNumUninitialized(GScore[GoalIndex] + 1, EAllowShrinking::No);
+	int32 Write = OutPath.Num() - 1;
+	for (int32 Index = GoalIndex; Index != INDEX_NONE; Index = Parent[Index])
+	{
+		OutPath[Write--] = Index;
+	}
+}
+
+void FGridReachability::Reset(int32 NumCells)
+{
+	if (Distance.Num() != NumCells)
+	{
+		Distance.Init(INDEX_NONE, NumCells);
+		Parent.Init(INDEX_NONE, NumCells);
+	}
+	else
+	{
+		// pulisce solo quello che era stato scritto
+		for (int32 Index : ReachedCells)
+		{
+			Distance[Index] = INDEX_NONE;
+			Parent[Index] = INDEX_NONE;
+		}
+	}
+
+	ReachedCells.Reset();
+	OriginIndex = INDEX_NONE;
+}
+
+void FGridReachability::BuildPath(int32 GoalIndex, TArray<int32>& OutPath) const
+{
+	OutPath.Reset();
+	if (!IsReachable(GoalIndex)) return;
+
+	OutPath.SetNumUninitialized(Distance[GoalIndex] + 1, EAllowShrinking::No);
+	int32 Write = OutPath.Num() - 1;
+	for (int32 Index = GoalIndex; Index != INDEX_NONE; Index = Parent[Index])
+	{
+		OutPath[Write--] = Index;
+	}
+}
+
+void FGridPathfinder::ComputeReachability(const FGridBoardState& Board, int32 OriginIndex, int32 MaxCost, FGridReachability& Out)
+{
+	Out.Reset(Board.NumCells());
+	Out.MaxCost = MaxCost;
+	Out.BoardRevision = Board.Revision;
+	if (OriginIndex < 0 || OriginIndex >= Board.NumCells()) return;
+
+	Out.OriginIndex = OriginIndex;
+	Out.Distance[OriginIndex] = 0;
+	Out.ReachedCells.Add(OriginIndex);
+
+	const int32 SizeY = Board.SizeY;
+
+	// ReachedCells fa anche da coda FIFO della BFS
+	for (int32 Head = 0; Head < Out.ReachedCells.Num(); Head++)
+	{
+		const int32 Current = Out.ReachedCells[Head];
+		const int32 NewDistance = Out.Distance[Current] + 1;
+		if (NewDistance > MaxCost) continue;
+
+		const int32 X = Current / SizeY;
+		const int32 Y = Current % SizeY;
+
+		int32 Neighbours[4];
+		int32 NumNeighbours = 0;
+		if (X + 1 < Board.SizeX) Neighbours[NumNeighbours++] = Current + SizeY;
+		if (X > 0)               Neighbours[NumNeighbours++] = Current - SizeY;
+		if (Y + 1 < SizeY)       Neighbours[NumNeighbours++] = Current + 1;
+		if (Y > 0)               Neighbours[NumNeighbours++] = Current - 1;
+
+		for (int32 i = 0; i < NumNeighbours; i++)
+		{
+			const int32 Next = Neighbours[i];
+			if (Out.Distance[Next] != INDEX_NONE || Board.IsBlocked(Next)) continue;
+
+			Out.Distance[Next] = NewDistance;
+			Out.Parent[Next] = Current;
+			Out.ReachedCells.Add(Next);
+		}
+	}
+}
+
+int32 FGridPathfinder::RepairReachability(const FGridBoardState& Board, const TArray<int32>& ChangedCells, FGridReachability& InOut)
+{
+	const int32 NumCells = Board.NumCells();
+	if (!InOut.IsValid() || InOut.Distance.Num() != NumCells)
+	{
+		ComputeReachability(Board, InOut.OriginIndex, InOut.MaxCost, InOut);
+		return InOut.ReachedCells.Num();
+	}
+
+	// SeenStamp = invalidata, ClosedStamp = già nel nuovo ReachedCells
+	BeginQuery(NumCells);
+	RepairInvalid.Reset();
+	RepairWritten.Reset();
+
+	const int32 SizeY = Board.SizeY;
+	const int32 OriginIndex = InOut.OriginIndex;
+	int32 Neighbours[4];
+	auto GetNeighbours = [&](int32 Index)
+	{
+		const int32 X = Index / SizeY;
+		const int32 Y = Index % SizeY;
+
+		int32 NumNeighbours = 0;
+		if (X + 1 < Board.SizeX) Neighbours[NumNeighbours++] = Index + SizeY;
+		if (X > 0)               Neighbours[NumNeighbours++] = Index - SizeY;
+		if (Y + 1 < SizeY)       Neighbours[NumNeighbours++] = Index + 1;
+		if (Y > 0)               Neighbours[NumNeighbours++] = Index - 1;
+		return NumNeighbours;
+	};
+
+	// celle cambiate già raggiunte e tutto ciò che ci passava attraverso
+	// (l'origine si espande comunque: è la cella dell'unità che si muove)
+	for (int32 Index : ChangedCells)
+	{
+		if (Index != OriginIndex && InOut.Distance[Index] != INDEX_NONE && !IsSeen(Index))
+		{
+			SeenStamp[Index] = Generation;
+			RepairInvalid.Add(Index);
+		}
+	}
+	for (int32 Head = 0; Head < RepairInvalid.Num(); Head++)
+	{
+		const int32 Current = RepairInvalid[Head];
+		const int32 NumNeighbours = GetNeighbours(Current);
+		for (int32 i = 0; i < NumNeighbours; i++)
+		{
+			const int32 Next = Neighbours[i];
+			if (InOut.Parent[Next] == Current && !IsSeen(Next))
+			{
+				SeenStamp[Next] = Generation;
+				RepairInvalid.Add(Next);
+			}
+		}
+	}
+	for (int32 Index : RepairInvalid)
+	{
+		InOut.Distance[Index] = INDEX_NONE;
+		InOut.Parent[Index] = INDEX_NONE;
+	}
+
+	OpenHeap.Reset();
+	auto WriteCell = [&](int32 Index, int32 NewDistance, int32 NewParent)
+	{
+		InOut.Distance[Index] = NewDistance;
+		InOut.Parent[Index] = NewParent;
+		RepairWritten.Add(Index);
+		OpenHeap.HeapPush({ NewDistance, 0, Index }, FOpenNodeLess());
+	};
+
+	// si riparte dal miglior vicino ancora raggiunto: ogni cella raggiunta si espande
+	// (le celle diventate bloccate sono tra quelle invalidate)
+	auto Reseed = [&](int32 Index)
+	{
+		if (InOut.Distance[Index] != INDEX_NONE || Board.IsBlocked(Index)) return;
+
+		int32 Best = INDEX_NONE;
+		const int32 NumNeighbours = GetNeighbours(Index);
+		for (int32 i = 0; i < NumNeighbours; i++)
+		{
+			const int32 Prev = Neighbours[i];
+			if (InOut.Distance[Prev] != INDEX_NONE && (Best == INDEX_NONE || InOut.Distance[Prev] < InOut.Distance[Best]))
+			{
+				Best = Prev;
+			}
+		}
+		if (Best != INDEX_NONE && InOut.Distance[Best] + 1 <= InOut.MaxCost)
+		{
+			WriteCell(Index, InOut.Distance[Best] + 1, Best);
+		}
+	};
+	for (int32 Index : RepairInvalid)
+	{
+		Reseed(Index);
+	}
+	for (int32 Index : ChangedCells)
+	{
+		Reseed(Index);
+	}
+
+	// punti di partenza a distanze diverse: coda con priorità invece della FIFO.
+	// Abbassa anche le celle rimaste valide a cui una cella liberata offre una strada più corta.
+	while (OpenHeap.Num() > 0)
+	{
+		FOpenNode Current;
+		OpenHeap.HeapPop(Current, FOpenNodeLess(), EAllowShrinking::No);
+		if (InOut.Distance[Current.Index] != Current.F) continue;
+
+		const int32 NewDistance = Current.F + 1;
+		if (NewDistance > InOut.MaxCost) continue;
+
+		const int32 NumNeighbours = GetNeighbours(Current.Index);
+		for (int32 i = 0; i < NumNeighbours; i++)
+		{
+			const int32 Next = Neighbours[i];
+			if (Board.IsBlocked(Next)) continue;
+
+			if (InOut.Distance[Next] == INDEX_NONE || NewDistance < InOut.Distance[Next])
+			{
+				WriteCell(Next, NewDistance, Current.Index);
+			}
+		}
+	}
+
+	// ReachedCells: via le celle perse, dentro le nuove, poi di nuovo in ordine di distanza come la BFS
+	int32 NumKept = 0;
+	auto KeepCell = [&](int32 Index)
+	{
+		if (InOut.Distance[Index] == INDEX_NONE || IsClosed(Index)) return;
+
+		ClosedStamp[Index] = Generation;
+		InOut.ReachedCells[NumKept++] = Index;
+	};
+	const int32 NumOld = InOut.ReachedCells.Num();
+	for (int32 i = 0; i < NumOld; i++)
+	{
+		KeepCell(InOut.ReachedCells[i]);
+	}
+	InOut.ReachedCells.SetNum(NumOld + RepairWritten.Num(), EAllowShrinking::No);
+	for (int32 Index : RepairWritten)
+	{
+		KeepCell(Index);
+	}
+	InOut.ReachedCells.SetNum(NumKept, EAllowShrinking::No);
+	InOut.ReachedCells.StableSort([&InOut](int32 A, int32 B)
+	{
+		return InOut.Distance[A] < InOut.Distance[B];
+	});
+
+	InOut.BoardRevision = Board.Revision;
+	return RepairInvalid.Num() + RepairWritten.Num();
+}
@@ -0,0 +1,185 @@
+#include "GridStaticDistances.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	// righe per task: abbastanza da ammortizzare la coda, abbastanza poche da bilanciare i worker
+	constexpr int32 RowsPerTask = 32;
+}
+
+bool FGridStaticDistances::Build(const FGridBoardState& Board)
+{
+	const int32 NewNumCells = Board.NumCells();
+	if (NewNumCells <= 0 || NewNumCells > MaxCells)
+	{
+		Reset();
+		return false;
+	}
+
+	NumCells = NewNumCells;
+	Table.SetNumUninitialized(NumCells * NumCells);
+
+	TArray<int32> Sources;
+	Sources.SetNumUninitialized(NumCells);
+	for (int32 Index = 0; Index < NumCells; Index++)
+	{
+		Sources[Index] = Index;
+	}
+
+	ComputeRows(Board, Sources);
+	return true;
+}
+
+void FGridStaticDistances::Reset()
+{
+	NumCells = 0;
+	Table.Empty();
+	LastRebuiltRows = 0;
+}
+
+void FGridStaticDistances::OnObstacleChanged(const FGridBoardState& Board, int32 Index)
+{
+	if (!Matches(Board) || Index < 0 || Index >= NumCells) return;
+
+	const bool bObstacle = Board.IsObstacle(Index);
+	uint8* RowC = Table.GetData() + Index * NumCells;
+
+	// la tabella sa già com'è la cella: niente da fare
+	if (bObstacle == (RowC[Index] == Unreachable)) return;
+
+	if (!bObstacle)
+	{
+		// cella liberata: i nuovi percorsi minimi o la evitano (valore vecchio) o ci passano una volta
+		TArray<int32> Queue;
+		Queue.Reserve(NumCells);
+		ComputeRow(Board, Index, RowC, Queue);
+
+		const int32 NumTasks = FMath::DivideAndRoundUp(NumCells, RowsPerTask);
+		ParallelFor(NumTasks, [this, Index, RowC](int32 Task)
+		{
+			const int32 End = FMath::Min(NumCells, (Task + 1) * RowsPerTask);
+			for (int32 A = Task * RowsPerTask; A < End; A++)
+			{
+				const uint8 DistanceAC = RowC[A]; // simmetrica: d(A,C) = d(C,A)
+				if (A == Index || DistanceAC == Unreachable) continue;
+
+				uint8* Row = Table.GetData() + A * NumCells;
+				for (int32 B = 0; B < NumCells; B++)
+				{
+					const uint8 DistanceCB = RowC[B];
+					if (DistanceCB == Unreachable) continue;
+
+					const uint8 Via = static_cast<uint8>(FMath::Min<int32>(DistanceAC + DistanceCB, MaxStored));
+					if (Via < Row[B]) Row[B] = Via;
+				}
+			}
+		});
+
+		LastRebuiltRows = 1;
+		return;
+	}
+
+	// cella bloccata: cambia solo chi aveva un percorso minimo attraverso di lei
+	TArray<uint8> DirtyRows;
+	DirtyRows.SetNumZeroed(NumCells);
+
+	const int32 NumTasks = FMath::DivideAndRoundUp(NumCells, RowsPerTask);
+	ParallelFor(NumTasks, [this, Index, RowC, &DirtyRows](int32 Task)
+	{
+		const int32 End = FMath::Min(NumCells, (Task + 1) * RowsPerTask);
+		for (int32 A = Task * RowsPerTask; A < End; A++)
+		{
+			const uint8 DistanceAC = RowC[A];
+			if (DistanceAC == Unreachable) continue;
+
+			const uint8* Row = GetRow(A);
+			for (int32 B = 0; B < NumCells; B++)
+			{
+				const uint8 DistanceCB = RowC[B];
+				if (B == Index || DistanceCB == Unreachable) continue;
+
+				// con la saturazione il confronto può solo dare falsi positivi, mai falsi negativi
+				if (FMath::Min<int32>(DistanceAC + DistanceCB, MaxStored) == Row[B])
+				{
+					DirtyRows[A] = 1;
+					break;
+				}
+			}
+		}
+	});
+
+	TArray<int32> Sources;
+	Sources.Add(Index);
+	for (int32 A = 0; A < NumCells; A++)
+	{
+		if (A == Index) continue;
+
+		if (DirtyRows[A])
+		{
+			Sources.Add(A);
+		}
+		else
+		{
+			// riga ancora valida tranne la cella stessa
+			Table[A * NumCells + Index] = Unreachable;
+		}
+	}
+
+	ComputeRows(Board, Sources);
+}
+
+void FGridStaticDistances::ComputeRows(const FGridBoardState& Board, const TArray<int32>& Sources)
+{
+	const int32 NumTasks = FMath::DivideAndRoundUp(Sources.Num(), RowsPerTask);
+	ParallelFor(NumTasks, [this, &Board, &Sources](int32 Task)
+	{
+		// coda per task, righe scritte in zone disgiunte della tabella
+		TArray<int32> Queue;
+		Queue.Reserve(NumCells);
+
+		const int32 End = FMath::Min(Sources.Num(), (Task + 1) * RowsPerTask);
+		for (int32 i = Task * RowsPerTask; i < End; i++)
+		{
+			ComputeRow(Board, Sources[i], Table.GetData() + Sources[i] * NumCells, Queue);
+		}
+	});
+
+	LastRebuiltRows = Sources.Num();
+}
+
+void FGridStaticDistances::ComputeRow(const FGridBoardState& Board, int32 Source, uint8* Row, TArray<int32>& Queue)
+{
+	FMemory::Memset(Row, Unreachable, Board.NumCells());
+	if (Board.IsObstacle(Source)) return;
+
+	const int32 SizeY = Board.SizeY;
+
+	Row[Source] = 0;
+	Queue.Reset();
+	Queue.Add(Source);
+
+	for (int32 Head = 0; Head < Queue.Num(); Head++)
+	{
+		const int32 Current = Queue[Head];
+		const uint8 NewDistance = static_cast<uint8>(FMath::Min<int32>(Row[Current] + 1, MaxStored));
+
+		const int32 X = Current / SizeY;
+		const int32 Y = Current % SizeY;
+
+		int32 Neighbours[4];
+		int32 NumNeighbours = 0;
+		if (X + 1 < Board.SizeX) Neighbours[NumNeighbours++] = Current + SizeY;
+		if (X > 0)               Neighbours[NumNeighbours++] = Current - SizeY;
+		if (Y + 1 < SizeY)       Neighbours[NumNeighbours++] = Current + 1;
+		if (Y > 0)               Neighbours[NumNeighbours++] = Current - 1;
+
+		for (int32 i = 0; i < NumNeighbours; i++)
+		{
+			const int32 Next = Neighbours[i];
+			if (Row[Next] != Unreachable || Board.IsObstacle(Next)) continue;
+
+			Row[Next] = NewDistance;
+			Queue.Add(Next);
+		}
+	}
+}
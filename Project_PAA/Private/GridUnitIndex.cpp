@@ -0,0 +1,295 @@
+#include "GridUnitIndex.h"
+
+void FGridUnitIndex::Init(int32 InSizeX, int32 InSizeY, int32 InBucketSize, int32 InLinearScanMaxUnits)
+{
+	SizeX = InSizeX;
+	SizeY = InSizeY;
+	BucketSize = FMath::Max(1, InBucketSize);
+	BucketsX = (SizeX + BucketSize - 1) / BucketSize;
+	BucketsY = (SizeY + BucketSize - 1) / BucketSize;
+	LinearScanMaxUnits = InLinearScanMaxUnits;
+
+	for (int32 Team = 0; Team < 2; Team++)
+	{
+		Heads[Team].Init(INDEX_NONE, BucketsX * BucketsY);
+		TeamCounts[Team] = 0;
+	}
+
+	Cells.Reset();
+	Coords.Reset();
+	Teams.Reset();
+	Next.Reset();
+	Prev.Reset();
+}
+
+void FGridUnitIndex::SetUnit(int32 Id, int32 CellIndex, bool bPlayerTeam)
+{
+	if (Id < 0) return;
+	if (CellIndex < 0 || CellIndex >= SizeX * SizeY)
+	{
+		RemoveUnit(Id);
+		return;
+	}
+
+	while (Cells.Num() <= Id)
+	{
+		Cells.Add(INDEX_NONE);
+		Coords.Add(FIntPoint(0, 0));
+		Teams.Add(0);
+		Next.Add(INDEX_NONE);
+		Prev.Add(INDEX_NONE);
+	}
+
+	Unlink(Id);
+	Cells[Id] = CellIndex;
+	Coords[Id] = FIntPoint(CellIndex / SizeY, CellIndex % SizeY);
+	Teams[Id] = bPlayerTeam ? 1 : 0;
+	Link(Id);
+}
+
+void FGridUnitIndex::RemoveUnit(int32 Id)
+{
+	if (!Cells.IsValidIndex(Id)) return;
+
+	Unlink(Id);
+	Cells[Id] = INDEX_NONE;
+}
+
+void FGridUnitIndex::Link(int32 Id)
+{
+	const int32 Team = Teams[Id];
+	int32& Head = Heads[Team][GetBucket(Cells[Id])];
+
+	Prev[Id] = INDEX_NONE;
+	Next[Id] = Head;
+	if (Head != INDEX_NONE)
+	{
+		Prev[Head] = Id;
+	}
+	Head = Id;
+	TeamCounts[Team]++;
+}
+
+void FGridUnitIndex::Unlink(int32 Id)
+{
+	if (Cells[Id] == INDEX_NONE) return;
+
+	const int32 Team = Teams[Id];
+	if (Prev[Id] != INDEX_NONE)
+	{
+		Next[Prev[Id]] = Next[Id];
+	}
+	else
+	{
+		Heads[Team][GetBucket(Cells[Id])] = Next[Id];
+	}
+	if (Next[Id] != INDEX_NONE)
+	{
+		Prev[Next[Id]] = Prev[Id];
+	}
+	TeamCounts[Team]--;
+}
+
+int32 FGridUnitIndex::GetBucketDistance(int32 X, int32 Y, int32 BX, int32 BY) const
+{
+	const int32 MinX = BX * BucketSize;
+	const int32 MaxX = FMath::Min(SizeX, MinX + BucketSize) - 1;
+	const int32 MinY = BY * BucketSize;
+	const int32 MaxY = FMath::Min(SizeY, MinY + BucketSize) - 1;
+
+	const int32 DX = FMath::Max3(0, MinX - X, X - MaxX);
+	const int32 DY = FMath::Max3(0, MinY - Y, Y - MaxY);
+	return DX + DY;
+}
+
+void FGridUnitIndex::QueryRange(bool bPlayerTeam, int32 CenterIndex, int32 Radius, TArray<int32>& OutIds) const
+{
+	OutIds.Reset();
+
+	const int32 Team = bPlayerTeam ? 1 : 0;
+	if (TeamCounts[Team] == 0 || Radius < 0 || CenterIndex < 0 || CenterIndex >= SizeX * SizeY) return;
+
+	const int32 X = CenterIndex / SizeY;
+	const int32 Y = CenterIndex % SizeY;
+
+	if (TeamCounts[Team] <= LinearScanMaxUnits)
+	{
+		for (int32 Id = 0; Id < Cells.Num(); Id++)
+		{
+			if (Cells[Id] != INDEX_NONE && Teams[Id] == Team && GetManhattan(Id, X, Y) <= Radius)
+			{
+				OutIds.Add(Id);
+			}
+		}
+		return;
+	}
+
+	const int32 MinBX = FMath::Max(0, X - Radius) / BucketSize;
+	const int32 MaxBX = FMath::Min(SizeX - 1, X + Radius) / BucketSize;
+	const int32 MinBY = FMath::Max(0, Y - Radius) / BucketSize;
+	const int32 MaxBY = FMath::Min(SizeY - 1, Y + Radius) / BucketSize;
+
+	for (int32 BX = MinBX; BX <= MaxBX; BX++)
+	{
+		for (int32 BY = MinBY; BY <= MaxBY; BY++)
+		{
+			// secchi negli angoli del rettangolo: fuori dal rombo
+			if (GetBucketDistance(X, Y, BX, BY) > Radius) continue;
+
+			for (int32 Id = Heads[Team][BX * BucketsY + BY]; Id != INDEX_NONE; Id = Next[Id])
+			{
+				if (GetManhattan(Id, X, Y) <= Radius)
+				{
+					OutIds.Add(Id);
+				}
+			}
+		}
+	}
+
+	OutIds.Sort();
+}
+
+void FGridUnitIndex::FindNearest(bool bPlayerTeam, int32 CenterIndex, int32 K, TArray<int32>& OutIds) const
+{
+	OutIds.Reset();
+
+	const int32 Team = bPlayerTeam ? 1 : 0;
+	if (TeamCounts[Team] == 0 || K <= 0 || CenterIndex < 0 || CenterIndex >= SizeX * SizeY) return;
+
+	const int32 X = CenterIndex / SizeY;
+	const int32 Y = CenterIndex % SizeY;
+	const int32 Wanted = FMath::Min(K, TeamCounts[Team]);
+
+	// (distanza << 32) | id: l'ordinamento dà distanza e poi id crescenti
+	TArray<uint64, TInlineAllocator<32>> Found;
+
+	if (TeamCounts[Team] <= LinearScanMaxUnits)
+	{
+		for (int32 Id = 0; Id < Cells.Num(); Id++)
+		{
+			if (Cells[Id] != INDEX_NONE && Teams[Id] == Team)
+			{
+				Found.Add((static_cast<uint64>(GetManhattan(Id, X, Y)) << 32) | static_cast<uint32>(Id));
+			}
+		}
+	}
+	else
+	{
+		// anelli di secchi attorno a quello del centro: all'anello Ring nessuna cella è più vicina
+		// di (Ring - 1) * BucketSize + 1, quindi ci si ferma appena i K migliori stanno sotto
+		const int32 CenterBX = X / BucketSize;
+		const int32 CenterBY = Y / BucketSize;
+		const int32 MaxRing = FMath::Max(FMath::Max(CenterBX, BucketsX - 1 - CenterBX), FMath::Max(CenterBY, BucketsY - 1 - CenterBY));
+		for (int32 Ring = 0; Ring <= MaxRing; Ring++)
+		{
+			const int32 RingDistance = Ring == 0 ? 0 : (Ring - 1) * BucketSize + 1;
+			const int32 Worst = Found.Num() >= Wanted ? static_cast<int32>(Found[Wanted - 1] >> 32) : MAX_int32;
+			if (Worst < RingDistance) break;
+
+			for (int32 BX = FMath::Max(0, CenterBX - Ring); BX <= FMath::Min(BucketsX - 1, CenterBX + Ring); BX++)
+			{
+				// sulle colonne interne solo i due secchi sul bordo dell'anello
+				const bool bEdgeColumn = FMath::Abs(BX - CenterBX) == Ring;
+				const int32 StepBY = bEdgeColumn || Ring == 0 ? 1 : 2 * Ring;
+
+				for (int32 BY = CenterBY - Ring; BY <= CenterBY + Ring; BY += StepBY)
+				{
+					if (BY < 0 || BY >= BucketsY) continue;
+					if (GetBucketDistance(X, Y, BX, BY) > Worst) continue;
+
+					for (int32 Id = Heads[Team][BX * BucketsY + BY]; Id != INDEX_NONE; Id = Next[Id])
+					{
+						Found.Add((static_cast<uint64>(GetManhattan(Id, X, Y)) << 32) | static_cast<uint32>(Id));
+					}
+				}
+			}
+
+			// tiene solo i K migliori: il confronto con l'anello successivo usa il K-esimo
+			if (Found.Num() >= Wanted)
+			{
+				Found.Sort();
+				Found.SetNum(Wanted, EAllowShrinking::No);
+			}
+		}
+	}
+
+	Found.Sort();
+	for (int32 i = 0; i < Found.Num() && i < Wanted; i++)
+	{
+		OutIds.Add(static_cast<int32>(Found[i] & 0xffffffffu));
+	}
+}
+
+int32 FGridUnitIndex::FindNearestBy(bool bPlayerTeam, int32 CenterIndex, TFunctionRef<int32(int32 Id, int32 CellIndex)> Distance,
+	int32* OutDistance) const
+{
+	int32 BestId = INDEX_NONE;
+	int32 BestDistance = MAX_int32;
+	int32 BestManhattan = MAX_int32;
+
+	const int32 Team = bPlayerTeam ? 1 : 0;
+	if (TeamCounts[Team] > 0 && CenterIndex >= 0 && CenterIndex < SizeX * SizeY)
+	{
+		const int32 X = CenterIndex / SizeY;
+		const int32 Y = CenterIndex % SizeY;
+
+		// Distance >= Manhattan: chi è oltre il migliore in Manhattan non può batterlo.
+		// A pari Distance vince il più vicino in Manhattan, poi l'id più basso
+		auto Consider = [&](int32 Id)
+		{
+			const int32 Manhattan = GetManhattan(Id, X, Y);
+			if (Manhattan > BestDistance) return;
+
+			const int32 Candidate = Distance(Id, Cells[Id]);
+			if (Candidate < BestDistance || (Candidate == BestDistance &&
+				(Manhattan < BestManhattan || (Manhattan == BestManhattan && Id < BestId))))
+			{
+				BestId = Id;
+				BestDistance = Candidate;
+				BestManhattan = Manhattan;
+			}
+		};
+
+		if (TeamCounts[Team] <= LinearScanMaxUnits)
+		{
+			for (int32 Id = 0; Id < Cells.Num(); Id++)
+			{
+				if (Cells[Id] != INDEX_NONE && Teams[Id] == Team) Consider(Id);
+			}
+		}
+		else
+		{
+			// anelli di secchi come in FindNearest, fermandosi quando l'anello è oltre il migliore
+			const int32 CenterBX = X / BucketSize;
+			const int32 CenterBY = Y / BucketSize;
+			const int32 MaxRing = FMath::Max(FMath::Max(CenterBX, BucketsX - 1 - CenterBX), FMath::Max(CenterBY, BucketsY - 1 - CenterBY));
+			for (int32 Ring = 0; Ring <= MaxRing; Ring++)
+			{
+				const int32 RingDistance = Ring == 0 ? 0 : (Ring - 1) * BucketSize + 1;
+				if (RingDistance > BestDistance) break;
+
+				for (int32 BX = FMath::Max(0, CenterBX - Ring); BX <= FMath::Min(BucketsX - 1, CenterBX + Ring); BX++)
+				{
+					const bool bEdgeColumn = FMath::Abs(BX - CenterBX) == Ring;
+					const int32 StepBY = bEdgeColumn || Ring == 0 ? 1 : 2 * Ring;
+
+					for (int32 BY = CenterBY - Ring; BY <= CenterBY + Ring; BY += StepBY)
+					{
+						if (BY < 0 || BY >= BucketsY || GetBucketDistance(X, Y, BX, BY) > BestDistance) continue;
+
+						for (int32 Id = Heads[Team][BX * BucketsY + BY]; Id != INDEX_NONE; Id = Next[Id])
+						{
+							Consider(Id);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if (OutDistance)
+	{
+		*OutDistance = BestDistance;
+	}
+	return BestId;
+}
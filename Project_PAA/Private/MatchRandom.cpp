@@ -0,0 +1,82 @@
+#include "MatchRandom.h"
+#include "MyGameMode.h"
+#include "Engine/World.h"
+
+namespace
+{
+	// SplitMix64: sparge seed vicini (0, 1, 2...) su stati lontani
+	uint64 SplitMix64(uint64& X)
+	{
+		uint64 Z = (X += 0x9e3779b97f4a7c15ull);
+		Z = (Z ^ (Z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		Z = (Z ^ (Z >> 27)) * 0x94d049bb133111ebull;
+		return Z ^ (Z >> 31);
+	}
+}
+
+void FPcg32::Seed(uint64 InSeed, uint64 Sequence)
+{
+	State = 0;
+	Inc = (Sequence << 1u) | 1u;
+	NextUInt32();
+	State += InSeed;
+	NextUInt32();
+}
+
+int32 FPcg32::RandRange(int32 Min, int32 Max)
+{
+	if (Max <= Min) return Min;
+
+	// moltiplicazione di Lemire con rigetto: nessun bias di modulo
+	const uint32 Range = static_cast<uint32>(Max - Min) + 1u;
+	uint64 M = static_cast<uint64>(NextUInt32()) * Range;
+	uint32 Low = static_cast<uint32>(M);
+	if (Low < Range)
+	{
+		const uint32 Threshold = (0u - Range) % Range;
+		while (Low < Threshold)
+		{
+			M = static_cast<uint64>(NextUInt32()) * Range;
+			Low = static_cast<uint32>(M);
+		}
+	}
+	return Min + static_cast<int32>(M >> 32);
+}
+
+void FMatchRandom::Initialize(uint64 InSeed)
+{
+	Seed = InSeed;
+	bInitialized = true;
+
+	uint64 Mixer = Seed;
+	for (int32 i = 0; i < static_cast<int32>(EMatchRandomStream::Count); i++)
+	{
+		Streams[i].Seed(SplitMix64(Mixer), static_cast<uint64>(i));
+	}
+}
+
+FPcg32 FMatchRandom::Fork(uint64 StreamIndex) const
+{
+	// sequenze oltre quelle dei sottosistemi, seed derivato da partita + indice
+	uint64 Mixer = Seed ^ (StreamIndex * 0xd1b54a32d192ed03ull);
+	return FPcg32(SplitMix64(Mixer), static_cast<uint64>(EMatchRandomStream::Count) + StreamIndex);
+}
+
+FPcg32& GetMatchRandomStream(const UObject* WorldContextObject, EMatchRandomStream Stream)
+{
+	if (const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr)
+	{
+		if (AMyGameMode* GameMode = Cast<AMyGameMode>(World->GetAuthGameMode()))
+		{
+			return GameMode->GetMatchRandom().Stream(Stream);
+		}
+	}
+
+	// nessuna partita (editor, tool): stream locale non riproducibile
+	static FMatchRandom Fallback;
+	if (!Fallback.IsInitialized())
+	{
+		Fallback.Initialize(FPlatformTime::Cycles64());
+	}
+	return Fallback.Stream(Stream);
+}
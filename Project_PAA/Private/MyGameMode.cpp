@@ -210,8 +210,9 @@ void AMyGameMode::SetupPlayerInput()
         InputMode.SetLockMouseToViewportBehavior(EMouseLockMode::DoNotLock);
         PC->SetInputMode(InputMode);
         PC->bShowMouseCursor = true;
-        PC->bEnableClickEvents = true;
-        PC->bEnableMouseOverEvents = true;
+        // click sulla griglia risolti dal GridManager: niente trace sotto il cursore per click e hover
+        PC->bEnableClickEvents = false;
+        PC->bEnableMouseOverEvents = false;
         UE_LOG(LogTemp, Warning, TEXT("Player input configured"));
     }
 }
@@ -240,8 +241,9 @@ void AMyGameMode::StartPlacementPhase()
                 FInputModeGameAndUI InputMode;
                 InputMode.SetWidgetToFocus(PlacementWidget->TakeWidget());
                 InputMode.SetLockMouseToViewportBehavior(EMouseLockMode::DoNotLock);
-                PlayerController->bEnableClickEvents = true;
-                PlayerController->bEnableMouseOverEvents = true;                PlayerController->SetInputMode(InputMode);
+                PlayerController->bEnableClickEvents = false;
+                PlayerController->bEnableMouseOverEvents = false;
+                PlayerController->SetInputMode(InputMode);
                 PlayerController->bShowMouseCursor = true;
                 // Debug: Print input settings
                 UE_LOG(LogTemp, Warning, TEXT("PlayerController settings - Click: %d, MouseOver: %d"), 
@@ -391,8 +393,7 @@ bool AMyGameMode::PlaceUnit(const FString& UnitType, const FVector2D& CellPositi
     AUnit* NewUnit = nullptr;
  FVector WorldPosition = GridManager->GetCellWorldPosition(CellPosition.X, CellPosition.Y);
 
-    AGridCell* Cell = GridManager->GetCellAtPosition(CellPosition);
-    if (!Cell || Cell->IsObstacle() || Cell->IsOccupied()) 
+    if (!GridManager->IsCellFree(CellPosition)) 
     {
         UE_LOG(LogTemp, Warning, TEXT("Invalid placement position!"));
         return false;
@@ -409,10 +410,9 @@ bool AMyGameMode::PlaceUnit(const FString& UnitType, const FVector2D& CellPositi
 
     if (NewUnit)
     {
-        NewUnit->SetGridPosition(CellPosition);
+        // squadra prima della posizione: la board registra il team all'ingresso in cella
         NewUnit->SetAsPlayerUnit(bIsPlayerTurn);
-
-        Cell->SetUnit(NewUnit);
+        NewUnit->SetGridPosition(CellPosition);
         UE_LOG(LogTemp, Warning, TEXT("%s placed at (%f, %f)"), *UnitType, CellPosition.X, CellPosition.Y);
         
         if (bIsPlayerTurn)
@@ -437,8 +437,7 @@ void AMyGameMode::CheckTurnCompletion()
 
 bool AMyGameMode::IsCellValidForPlacement(FVector2D CellPosition)
 {
-    AGridCell* Cell = GridManager->GetCellAtPosition(CellPosition);
-    return Cell && !Cell->IsObstacle() && !Cell->IsOccupied();
+    return GridManager->IsCellFree(CellPosition);
 }
 
 bool AMyGameMode::CanPlaceSniper() const
@@ -510,7 +509,7 @@ void AMyGameMode::ClearSelection()
     bMovementRangeVisible = false;
     bIsAttackHighlighted = false;
     bWaitingForAttackTarget = false;
-    bWaitingForMoveTarget = false;
+    SetWaitingForMoveTarget(false);
 
     if (GridManager)
     {
@@ -526,6 +525,16 @@ void AMyGameMode::ClearSelection()
     HideActionWidget();
 }
 
+void AMyGameMode::SetWaitingForMoveTarget(bool bWaiting)
+{
+    bWaitingForMoveTarget = bWaiting;
+
+    if (GridManager)
+    {
+        GridManager->SetMoveTargeting(bWaiting);
+    }
+}
+
 
 void AMyGameMode::StartPlayerTurn()
 {
@@ -629,13 +638,17 @@ void AMyGameMode::StartActionPhase()
 
 void AMyGameMode::EndTurn()
 {
-    bIsPlayerTurn = !bIsPlayerTurn;
-    
-    // Reset unit states
-    for (AUnit* Unit : bIsPlayerTurn ? PlayerUnits : AIUnits)
+    // cambio turno e reset dei flag dalle regole condivise
+    FTacticsGameState State;
+    if (BuildSimulationState(State))
     {
-        Unit->bHasMovedThisTurn = false;
-        Unit->bHasAttackedThisTurn = false;
+        FTacticsRules::EndTurn(State);
+        bIsPlayerTurn = State.bPlayerToMove;
+        ApplySimulationState(State);
+    }
+    else
+    {
+        bIsPlayerTurn = !bIsPlayerTurn;
     }
 
     // Start next turn
@@ -654,6 +667,54 @@ void AMyGameMode::EndTurn()
 }
 
 
+FMatchRandom& AMyGameMode::GetMatchRandom()
+{
+    if (!MatchRandom.IsInitialized())
+    {
+        // il GridManager può chiederlo prima del nostro BeginPlay (ostacoli)
+        const uint64 Seed = MatchSeed != 0 ? static_cast<uint64>(static_cast<uint32>(MatchSeed)) : FPlatformTime::Cycles64();
+        MatchRandom.Initialize(Seed);
+        UE_LOG(LogTemp, Warning, TEXT("Match random seed: %llu"), Seed);
+    }
+    return MatchRandom;
+}
+
+bool AMyGameMode::BuildSimulationState(FTacticsGameState& OutState) const
+{
+    if (!GridManager) return false;
+
+    FTacticsGameState::Build(*GridManager, PlayerUnits, AIUnits, bIsPlayerTurn, OutState);
+    return true;
+}
+
+void AMyGameMode::ApplySimulationState(const FTacticsGameState& State)
+{
+    if (!GridManager) return;
+
+    for (const FSimUnit& Sim : State.Units)
+    {
+        AUnit* Unit = GridManager->GetRegisteredUnit(Sim.UnitId);
+        if (!IsValid(Unit)) continue;
+
+        Unit->Health = Sim.Health;
+        Unit->bHasMovedThisTurn = Sim.bHasMoved;
+        Unit->bHasAttackedThisTurn = Sim.bHasAttacked;
+
+        if (!Sim.IsAlive())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("%s è stato distrutto!"), *Unit->GetName());
+            Unit->DestroyUnit(); // toglie l'unità da griglia e liste
+            continue;
+        }
+
+        if (GridManager->GetUnitCellIndex(Unit) != Sim.CellIndex)
+        {
+            const FIntPoint Coord = GridManager->GetCellCoord(Sim.CellIndex);
+            Unit->MoveToCell(FVector2D(Coord.X, Coord.Y));
+        }
+    }
+}
+
 void AMyGameMode::LogTurnState()
 {
     UE_LOG(LogTemp, Warning, TEXT("Turn State - Phase: %d, PlayerTurn: %d"), 
@@ -710,7 +771,7 @@ void AMyGameMode::HandleMoveAction()
         GridManager->ClearHighlights();
        
         bMovementRangeVisible = false;
-        bWaitingForMoveTarget = false;
+        SetWaitingForMoveTarget(false);
     }
     else
     {
@@ -721,7 +782,7 @@ void AMyGameMode::HandleMoveAction()
             true
         );
         bMovementRangeVisible = true;
-        bWaitingForMoveTarget = true; 
+        SetWaitingForMoveTarget(true);
     }
 
     HideActionWidget();
@@ -748,7 +809,7 @@ void AMyGameMode::HandleAttackAction()
         {
             GridManager->ClearHighlights();
             bMovementRangeVisible = false;
-            bWaitingForMoveTarget = false;
+            SetWaitingForMoveTarget(false);
         }
 
         CurrentActionState = EUnitActionState::Attacking;
@@ -0,0 +1,438 @@
+#include "TacticsAI.h"
+#include "TacticsTranspositionTable.h"
+
+bool FTacticsAI::FindBestPlan(const FTacticsGameState& State, const FTacticsAISettings& InSettings, FTacticsUnitPlan& OutPlan)
+{
+	Settings = InSettings;
+	Stats = FTacticsAIStats();
+	bAborted = false;
+
+	const double StartTime = FPlatformTime::Seconds();
+	Deadline = StartTime + Settings.TimeBudgetSeconds;
+
+	// un ply per azione più un eventuale cambio turno per livello
+	const int32 StackSize = 2 * FMath::Max(1, Settings.MaxDepth) + 2;
+	if (Stack.Num() < StackSize)
+	{
+		Stack.SetNum(StackSize);
+	}
+
+	bGeneratingRoot = true;
+	GeneratePlans(State, Settings.MaxMoveCandidates, RootPlans);
+	bGeneratingRoot = false;
+	if (RootPlans.Num() == 0) return false;
+
+	if (TranspositionTable)
+	{
+		TranspositionTable->NewSearch();
+
+		// il piano migliore di una ricerca precedente sulla stessa posizione va cercato per primo
+		FTacticsTTEntry Entry;
+		if (TranspositionTable->Probe(State.Hash, Entry))
+		{
+			PromotePlan(RootPlans, Entry.BestPlan);
+		}
+	}
+
+	// ripiego se nemmeno la profondità 1 finisce in tempo
+	OutPlan = RootPlans[0];
+	if (RootPlans.Num() == 1) return true;
+
+	const bool bMaximize = !State.bPlayerToMove;
+
+	for (int32 Depth = 1; Depth <= Settings.MaxDepth; Depth++)
+	{
+		float Alpha = -TNumericLimits<float>::Max();
+		float Beta = TNumericLimits<float>::Max();
+		float Best = bMaximize ? Alpha : Beta;
+		int32 BestIndex = 0;
+
+		for (int32 i = 0; i < RootPlans.Num(); i++)
+		{
+			const float Value = SearchPlan(State, RootPlans[i], Depth, 0, Alpha, Beta);
+			if (bAborted) break;
+
+			if (bMaximize ? Value > Best : Value < Best)
+			{
+				Best = Value;
+				BestIndex = i;
+			}
+
+			if (bMaximize) Alpha = FMath::Max(Alpha, Best);
+			else Beta = FMath::Min(Beta, Best);
+		}
+
+		// iterazione incompleta: resta il risultato della profondità precedente
+		if (bAborted) break;
+
+		// il migliore va in testa e viene cercato per primo alla profondità successiva
+		const FTacticsUnitPlan BestPlan = RootPlans[BestIndex];
+		RootPlans.RemoveAt(BestIndex, 1, EAllowShrinking::No);
+		RootPlans.Insert(BestPlan, 0);
+
+		OutPlan = BestPlan;
+		Stats.CompletedDepth = Depth;
+		Stats.BestValue = Best;
+
+		if (TranspositionTable)
+		{
+			TranspositionTable->Store(State.Hash, { Best, Depth, ETacticsBound::Exact, BestPlan });
+		}
+
+		// esito già deciso: cercare più a fondo non cambia la scelta
+		if (FMath::Abs(Best) >= WinScore) break;
+	}
+
+	Stats.bTimedOut = bAborted;
+	Stats.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+	return true;
+}
+
+float FTacticsAI::Search(const FTacticsGameState& State, int32 Depth, int32 Ply, float Alpha, float Beta)
+{
+	Stats.Nodes++;
+	if (IsOutOfTime()) return 0.f;
+
+	if (Depth <= 0 || Ply >= Stack.Num() || !State.IsSideAlive(true) || !State.IsSideAlive(false))
+	{
+		return Evaluate(State);
+	}
+
+	FPlyScratch& Scratch = Stack[Ply];
+
+	if (FTacticsRules::IsTurnComplete(State))
+	{
+		// il cambio turno non consuma profondità
+		Scratch.TurnState = State;
+		FTacticsRules::EndTurn(Scratch.TurnState);
+		return Search(Scratch.TurnState, Depth, Ply + 1, Alpha, Beta);
+	}
+
+	// stessa posizione raggiunta con un altro ordine di mosse
+	FTacticsTTEntry Entry;
+	const bool bHasEntry = TranspositionTable && TranspositionTable->Probe(State.Hash, Entry);
+	if (bHasEntry && Entry.Depth >= Depth)
+	{
+		if (Entry.Bound == ETacticsBound::Exact)
+		{
+			Stats.TableHits++;
+			return Entry.Value;
+		}
+		if (Entry.Bound == ETacticsBound::Lower) Alpha = FMath::Max(Alpha, Entry.Value);
+		else Beta = FMath::Min(Beta, Entry.Value);
+
+		if (Alpha >= Beta)
+		{
+			Stats.TableHits++;
+			return Entry.Value;
+		}
+	}
+
+	GeneratePlans(State, Settings.MaxMoveCandidates, Scratch.Plans);
+	if (bHasEntry)
+	{
+		PromotePlan(Scratch.Plans, Entry.BestPlan);
+	}
+
+	const float AlphaStart = Alpha;
+	const float BetaStart = Beta;
+	const bool bMaximize = !State.bPlayerToMove;
+	float Best = bMaximize ? -TNumericLimits<float>::Max() : TNumericLimits<float>::Max();
+	int32 BestIndex = 0;
+
+	for (int32 i = 0; i < Scratch.Plans.Num(); i++)
+	{
+		const float Value = SearchPlan(State, Scratch.Plans[i], Depth, Ply, Alpha, Beta);
+		if (bAborted) return 0.f;
+
+		if (bMaximize ? Value > Best : Value < Best)
+		{
+			Best = Value;
+			BestIndex = i;
+		}
+
+		if (bMaximize) Alpha = FMath::Max(Alpha, Best);
+		else Beta = FMath::Min(Beta, Best);
+
+		if (Alpha >= Beta) break; // taglio
+	}
+
+	if (TranspositionTable)
+	{
+		const ETacticsBound Bound = Best <= AlphaStart ? ETacticsBound::Upper
+			: Best >= BetaStart ? ETacticsBound::Lower
+			: ETacticsBound::Exact;
+		TranspositionTable->Store(State.Hash, { Best, Depth, Bound, Scratch.Plans[BestIndex] });
+	}
+
+	return Best;
+}
+
+float FTacticsAI::SearchPlan(const FTacticsGameState& State, const FTacticsUnitPlan& Plan, int32 Depth, int32 Ply, float Alpha, float Beta)
+{
+	FTacticsGameState& AfterMove = Stack[Ply].MoveState;
+	AfterMove = State;
+	ApplyPlanMove(AfterMove, Plan);
+
+	if (Plan.TargetSlot == INDEX_NONE)
+	{
+		return Search(AfterMove, Depth - 1, Ply + 1, Alpha, Beta);
+	}
+	return ExpectedAttackValue(AfterMove, Plan, Depth, Ply);
+}
+
+float FTacticsAI::ExpectedAttackValue(const FTacticsGameState& AfterMove, const FTacticsUnitPlan& Plan, int32 Depth, int32 Ply)
+{
+	const FSimUnit& Attacker = AfterMove.Units[Plan.UnitSlot];
+	const FSimUnit& Target = AfterMove.Units[Plan.TargetSlot];
+
+	const int32 MinCounter = FTacticsRules::CounterMinDamage;
+	const int32 MaxCounter = FTacticsRules::CounterMaxDamage;
+	const float DamageP = 1.f / (Attacker.MaxDamage - Attacker.MinDamage + 1);
+	const float CounterP = 1.f / (MaxCounter - MinCounter + 1);
+
+	float Expected = 0.f;
+
+	for (int32 Damage = Attacker.MinDamage; Damage <= Attacker.MaxDamage; Damage++)
+	{
+		if (Damage >= Target.Health)
+		{
+			// da qui in su il bersaglio muore sempre: un solo figlio con il peso di tutti i tiri
+			Expected += DamageP * (Attacker.MaxDamage - Damage + 1) * SearchRoll(AfterMove, Plan, Damage, 0, Depth, Ply);
+			break;
+		}
+
+		if (!FTacticsRules::WouldCounterattack(AfterMove, Plan.UnitSlot, Plan.TargetSlot, Damage))
+		{
+			Expected += DamageP * SearchRoll(AfterMove, Plan, Damage, 0, Depth, Ply);
+			continue;
+		}
+
+		for (int32 Counter = MinCounter; Counter <= MaxCounter; Counter++)
+		{
+			if (Counter >= Attacker.Health)
+			{
+				// stesso raggruppamento per i contrattacchi letali
+				Expected += DamageP * CounterP * (MaxCounter - Counter + 1) * SearchRoll(AfterMove, Plan, Damage, Counter, Depth, Ply);
+				break;
+			}
+			Expected += DamageP * CounterP * SearchRoll(AfterMove, Plan, Damage, Counter, Depth, Ply);
+		}
+
+		if (bAborted) return 0.f;
+	}
+
+	return Expected;
+}
+
+float FTacticsAI::SearchRoll(const FTacticsGameState& AfterMove, const FTacticsUnitPlan& Plan, int32 Damage, int32 CounterDamage,
+	int32 Depth, int32 Ply)
+{
+	FTacticsGameState& Rolled = Stack[Ply].RollState;
+	Rolled = AfterMove;
+
+	FSimAttackResult Result;
+	Rules.ApplyAttackWithRolls(Rolled, Plan.UnitSlot, Plan.TargetSlot, Damage, CounterDamage, Result);
+
+	// i figli di un nodo di chance vanno valutati esatti: finestra piena
+	return Search(Rolled, Depth - 1, Ply + 1, -TNumericLimits<float>::Max(), TNumericLimits<float>::Max());
+}
+
+void FTacticsAI::ApplyPlanMove(FTacticsGameState& State, const FTacticsUnitPlan& Plan)
+{
+	if (!State.Units[Plan.UnitSlot].bHasMoved)
+	{
+		FTacticsRules::ApplyMoveUnchecked(State, Plan.UnitSlot, Plan.MoveCell);
+	}
+
+	// rinunciare all'attacco chiude il turno dell'unità
+	if (Plan.TargetSlot == INDEX_NONE)
+	{
+		State.SetHasAttacked(Plan.UnitSlot, true);
+	}
+}
+
+void FTacticsAI::GeneratePlans(const FTacticsGameState& State, int32 MaxMoveCandidates, TArray<FTacticsUnitPlan>& OutPlans)
+{
+	OutPlans.Reset();
+
+	// bersagli e nemico più vicino per ogni cella candidata dall'indice
+	// (con pochi nemici è l'indice stesso a scorrerli)
+	UnitIndex.Init(State.Board.SizeX, State.Board.SizeY);
+	for (int32 Slot = 0; Slot < State.Units.Num(); Slot++)
+	{
+		const FSimUnit& Unit = State.Units[Slot];
+		if (Unit.IsAlive())
+		{
+			UnitIndex.SetUnit(Slot, Unit.CellIndex, Unit.bIsPlayer);
+		}
+	}
+
+	for (int32 Slot = 0; Slot < State.Units.Num(); Slot++)
+	{
+		const FSimUnit& Unit = State.Units[Slot];
+		if (Unit.bIsPlayer != State.bPlayerToMove || !Unit.IsAlive()) continue;
+		if (Unit.bHasMoved && Unit.bHasAttacked) continue;
+
+		// celle candidate: quelle da cui si attacca e quelle più vicine al nemico
+		Candidates.Reset();
+		if (Unit.bHasMoved)
+		{
+			Candidates.Add({ Unit.CellIndex, 0 });
+		}
+		else
+		{
+			// alla radice: più vicino a una cella d'attacco è meglio, a piedi e con le unità in mezzo;
+			// sulle celle d'attacco (e senza campo) decide ScoreCell
+			const FTacticsApproachField* Approach = bGeneratingRoot ? FindApproachField(State, Unit) : nullptr;
+			auto Score = [&](int32 Cell)
+			{
+				const int32 Distance = Approach ? Approach->Distance[Cell] : INDEX_NONE;
+				return Distance > 0 ? -Distance : ScoreCell(State, Unit, Cell);
+			};
+
+			const FGridReachability& Reach = Rules.GetMoveReachability(State, Slot);
+			for (int32 Cell : Reach.ReachedCells)
+			{
+				Candidates.Add({ Cell, Score(Cell) });
+			}
+
+			Candidates.Sort([](const FCandidateCell& A, const FCandidateCell& B) { return A.Score > B.Score; });
+
+			const int32 MaxCandidates = FMath::Max(1, MaxMoveCandidates);
+			if (Candidates.Num() > MaxCandidates)
+			{
+				// restare fermi resta sempre un'opzione
+				bool bKeepsOrigin = false;
+				for (int32 i = 0; i < MaxCandidates; i++)
+				{
+					bKeepsOrigin |= Candidates[i].Cell == Unit.CellIndex;
+				}
+
+				Candidates.SetNum(MaxCandidates, EAllowShrinking::No);
+				if (!bKeepsOrigin)
+				{
+					Candidates.Last() = { Unit.CellIndex, Score(Unit.CellIndex) };
+				}
+			}
+		}
+
+		for (const FCandidateCell& Candidate : Candidates)
+		{
+			if (!Unit.bHasAttacked)
+			{
+				FindTargetsFrom(State, Unit, Candidate.Cell, TargetSlots);
+				for (const int32 TargetSlot : TargetSlots)
+				{
+					const FSimUnit& Target = State.Units[TargetSlot];
+
+					// attacchi per primi, prima quelli che possono uccidere
+					const int32 KillBonus = Unit.MaxDamage >= Target.Health ? 500 : 0;
+					OutPlans.Add({ Slot, Candidate.Cell, TargetSlot, 1000 + KillBonus - Target.Health });
+				}
+			}
+
+			OutPlans.Add({ Slot, Candidate.Cell, INDEX_NONE, Candidate.Score });
+		}
+	}
+
+	OutPlans.Sort([](const FTacticsUnitPlan& A, const FTacticsUnitPlan& B) { return A.OrderScore > B.OrderScore; });
+}
+
+void FTacticsAI::PromotePlan(TArray<FTacticsUnitPlan>& Plans, const FTacticsUnitPlan& Plan)
+{
+	for (int32 i = 1; i < Plans.Num(); i++)
+	{
+		if (Plans[i].UnitSlot == Plan.UnitSlot && Plans[i].MoveCell == Plan.MoveCell && Plans[i].TargetSlot == Plan.TargetSlot)
+		{
+			const FTacticsUnitPlan Promoted = Plans[i];
+			Plans.RemoveAt(i, 1, EAllowShrinking::No);
+			Plans.Insert(Promoted, 0);
+			return;
+		}
+	}
+}
+
+const FTacticsApproachField* FTacticsAI::FindApproachField(const FTacticsGameState& State, const FSimUnit& Unit) const
+{
+	if (!ApproachFields) return nullptr;
+
+	for (const FTacticsApproachField& Field : *ApproachFields)
+	{
+		if (Field.BoardRevision == State.Board.Revision && Field.Distance.Num() == State.Board.NumCells() &&
+			Field.bTargetPlayerTeam != Unit.bIsPlayer && Field.AttackRange == Unit.AttackRange && Field.bRanged == Unit.bIsRanged)
+		{
+			return &Field;
+		}
+	}
+	return nullptr;
+}
+
+void FTacticsAI::FindTargetsFrom(const FTacticsGameState& State, const FSimUnit& Unit, int32 Cell, TArray<int32>& OutSlots) const
+{
+	// il corpo a corpo arriva solo alle celle adiacenti
+	const int32 Radius = Unit.bIsRanged ? Unit.AttackRange : FMath::Min(Unit.AttackRange, 1);
+	UnitIndex.QueryRange(!Unit.bIsPlayer, Cell, Radius, OutSlots);
+
+	OutSlots.RemoveAll([&](int32 TargetSlot)
+	{
+		return !FTacticsRules::IsInAttackRange(State.Board, Unit, Cell, State.Units[TargetSlot].CellIndex);
+	});
+}
+
+int32 FTacticsAI::ScoreCell(const FTacticsGameState& State, const FSimUnit& Unit, int32 Cell)
+{
+	// la distanza a piedi non scende mai sotto Manhattan: bastano i nemici più vicini in Manhattan
+	int32 Nearest = MAX_int32;
+	UnitIndex.FindNearestBy(!Unit.bIsPlayer, Cell, [&State, Cell](int32 Slot, int32 EnemyCell)
+	{
+		return State.GetWalkDistance(Cell, EnemyCell);
+	}, &Nearest);
+
+	// il range d'attacco è Manhattan: se il nemico più vicino non è a tiro non lo è nessuno
+	UnitIndex.FindNearest(!Unit.bIsPlayer, Cell, 1, TargetSlots);
+	const bool bCanAttack = TargetSlots.Num() > 0 &&
+		FTacticsRules::IsInAttackRange(State.Board, Unit, Cell, State.Units[TargetSlots[0]].CellIndex);
+
+	if (Nearest == MAX_int32) return 0;
+
+	// lo Sniper preferisce la distanza massima di tiro, il Brawler l'adiacenza
+	const int32 Desired = Unit.bIsRanged ? Unit.AttackRange : 1;
+	return (bCanAttack ? 100 : 0) - FMath::Abs(Nearest - Desired);
+}
+
+float FTacticsAI::Evaluate(const FTacticsGameState& State)
+{
+	if (!State.IsSideAlive(false)) return -WinScore;
+	if (!State.IsSideAlive(true)) return WinScore;
+
+	float Score = 0.f;
+
+	for (const FSimUnit& Unit : State.Units)
+	{
+		if (!Unit.IsAlive()) continue;
+
+		int32 Nearest = MAX_int32;
+		for (const FSimUnit& Enemy : State.Units)
+		{
+			if (Enemy.bIsPlayer == Unit.bIsPlayer || !Enemy.IsAlive()) continue;
+			Nearest = FMath::Min(Nearest, State.GetWalkDistance(Unit.CellIndex, Enemy.CellIndex));
+		}
+
+		const int32 Desired = Unit.bIsRanged ? Unit.AttackRange : 1;
+		const float UnitScore = UnitAliveValue + HealthValue * Unit.Health - ApproachPenalty * FMath::Max(0, Nearest - Desired);
+		Score += Unit.bIsPlayer ? -UnitScore : UnitScore;
+	}
+
+	return Score;
+}
+
+bool FTacticsAI::IsOutOfTime()
+{
+	// l'orologio si legge ogni 256 nodi
+	if (!bAborted && (Stats.Nodes & 255) == 0 && FPlatformTime::Seconds() >= Deadline)
+	{
+		bAborted = true;
+	}
+	return bAborted;
+}
@@ -0,0 +1,367 @@
+#include "TacticsMCTS.h"
+#include "MatchRandom.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+
+struct FTacticsMCTS::FWorker
+{
+	struct FNode
+	{
+		FTacticsUnitPlan Plan;
+		int32 FirstChild = INDEX_NONE;
+		int32 NumChildren = 0;
+		int32 Visits = 0;
+		int32 Availability = 0; // volte in cui il figlio era legale quando il padre è stato attraversato
+		float TotalValue = 0.f; // somma delle ricompense dell'IA
+		bool bExpanded = false;
+	};
+
+	TArray<FNode> Nodes;
+	TArray<int32> Path;
+	TArray<int32> LegalChildren;
+	TArray<FTacticsUnitPlan> Plans;
+	TArray<int32> Targets;
+
+	FTacticsGameState State;
+	FTacticsAI PlanGenerator;
+	FTacticsRules Rules;
+	FPcg32 Random;
+
+	// reachability dell'ultima unità controllata, valida fino alla prossima mossa
+	int32 ReachSlot = INDEX_NONE;
+	const FGridReachability* Reach = nullptr;
+
+	int32 Rollouts = 0;
+
+	void Run(const FTacticsGameState& Root, const FTacticsMCTSSettings& Settings, double Deadline);
+	void RunIteration(const FTacticsGameState& Root, const FTacticsMCTSSettings& Settings);
+	void Expand(int32 NodeIndex, const FTacticsMCTSSettings& Settings);
+	int32 SelectChild(int32 NodeIndex, float Exploration);
+	bool IsPlanLegal(const FTacticsUnitPlan& Plan);
+	void ApplyPlan(const FTacticsUnitPlan& Plan);
+	float Rollout(const FTacticsMCTSSettings& Settings);
+	bool PickRandomPlan(FTacticsUnitPlan& OutPlan);
+	float GetReward() const;
+};
+
+void FTacticsMCTS::FWorker::Run(const FTacticsGameState& Root, const FTacticsMCTSSettings& Settings, double Deadline)
+{
+	Nodes.Reset();
+	Nodes.AddDefaulted_GetRef(); // radice
+	Rollouts = 0;
+
+	do
+	{
+		RunIteration(Root, Settings);
+	}
+	while (FPlatformTime::Seconds() < Deadline);
+}
+
+void FTacticsMCTS::FWorker::RunIteration(const FTacticsGameState& Root, const FTacticsMCTSSettings& Settings)
+{
+	State = Root;
+	ReachSlot = INDEX_NONE;
+
+	Path.Reset();
+	Path.Add(0);
+
+	int32 NodeIndex = 0;
+
+	// selezione: scende finché trova un figlio mai visitato
+	while (State.IsSideAlive(true) && State.IsSideAlive(false))
+	{
+		if (FTacticsRules::IsTurnComplete(State))
+		{
+			// il cambio turno non è un nodo dell'albero
+			FTacticsRules::EndTurn(State);
+			ReachSlot = INDEX_NONE;
+			continue;
+		}
+
+		if (!Nodes[NodeIndex].bExpanded)
+		{
+			if (Nodes.Num() >= Settings.MaxTreeNodes) break;
+			Expand(NodeIndex, Settings);
+		}
+
+		const int32 Child = SelectChild(NodeIndex, Settings.Exploration);
+		if (Child == INDEX_NONE) break;
+
+		ApplyPlan(Nodes[Child].Plan);
+		Path.Add(Child);
+		NodeIndex = Child;
+
+		if (Nodes[Child].Visits == 0) break;
+	}
+
+	const float Reward = Rollout(Settings);
+	Rollouts++;
+
+	for (int32 Index : Path)
+	{
+		Nodes[Index].Visits++;
+		Nodes[Index].TotalValue += Reward;
+	}
+}
+
+void FTacticsMCTS::FWorker::Expand(int32 NodeIndex, const FTacticsMCTSSettings& Settings)
+{
+	PlanGenerator.GeneratePlans(State, Settings.MaxMoveCandidates, Plans);
+
+	// raggruppati per unità: una sola BFS per unità nel controllo di legalità
+	Plans.StableSort([](const FTacticsUnitPlan& A, const FTacticsUnitPlan& B) { return A.UnitSlot < B.UnitSlot; });
+
+	const int32 FirstChild = Nodes.Num();
+	for (const FTacticsUnitPlan& Plan : Plans)
+	{
+		Nodes.AddDefaulted_GetRef().Plan = Plan;
+	}
+
+	FNode& Node = Nodes[NodeIndex];
+	Node.FirstChild = FirstChild;
+	Node.NumChildren = Plans.Num();
+	Node.bExpanded = true;
+}
+
+int32 FTacticsMCTS::FWorker::SelectChild(int32 NodeIndex, float Exploration)
+{
+	const FNode& Node = Nodes[NodeIndex];
+
+	LegalChildren.Reset();
+	int32 NumUnvisited = 0;
+	for (int32 Child = Node.FirstChild; Child < Node.FirstChild + Node.NumChildren; Child++)
+	{
+		if (!IsPlanLegal(Nodes[Child].Plan)) continue;
+
+		LegalChildren.Add(Child);
+		Nodes[Child].Availability++;
+		NumUnvisited += Nodes[Child].Visits == 0;
+	}
+
+	if (LegalChildren.Num() == 0) return INDEX_NONE;
+
+	if (NumUnvisited > 0)
+	{
+		// prima ogni figlio legale almeno una volta, in ordine casuale
+		int32 Pick = Random.RandRange(0, NumUnvisited - 1);
+		for (int32 Child : LegalChildren)
+		{
+			if (Nodes[Child].Visits == 0 && Pick-- == 0) return Child;
+		}
+	}
+
+	// UCB1 con la disponibilità al posto delle visite del padre (open-loop)
+	const bool bAIToMove = !State.bPlayerToMove;
+	int32 BestChild = INDEX_NONE;
+	float BestScore = -TNumericLimits<float>::Max();
+
+	for (int32 Child : LegalChildren)
+	{
+		const FNode& Candidate = Nodes[Child];
+		const float Mean = Candidate.TotalValue / Candidate.Visits;
+		const float Exploit = bAIToMove ? Mean : 1.f - Mean;
+		const float Score = Exploit + Exploration * FMath::Sqrt(FMath::Loge(static_cast<float>(Candidate.Availability)) / Candidate.Visits);
+
+		if (Score > BestScore)
+		{
+			BestScore = Score;
+			BestChild = Child;
+		}
+	}
+	return BestChild;
+}
+
+bool FTacticsMCTS::FWorker::IsPlanLegal(const FTacticsUnitPlan& Plan)
+{
+	const FSimUnit& Unit = State.Units[Plan.UnitSlot];
+	if (!Unit.IsAlive() || Unit.bIsPlayer != State.bPlayerToMove) return false;
+	if (Unit.bHasMoved && Unit.bHasAttacked) return false;
+
+	if (Unit.bHasMoved)
+	{
+		if (Plan.MoveCell != Unit.CellIndex) return false;
+	}
+	else
+	{
+		if (ReachSlot != Plan.UnitSlot)
+		{
+			Reach = &Rules.GetMoveReachability(State, Plan.UnitSlot);
+			ReachSlot = Plan.UnitSlot;
+		}
+		if (!Reach->IsReachable(Plan.MoveCell)) return false;
+	}
+
+	if (Plan.TargetSlot == INDEX_NONE) return true;
+
+	const FSimUnit& Target = State.Units[Plan.TargetSlot];
+	return !Unit.bHasAttacked && Target.IsAlive() && Target.bIsPlayer != Unit.bIsPlayer &&
+		FTacticsRules::IsInAttackRange(State.Board, Unit, Plan.MoveCell, Target.CellIndex);
+}
+
+void FTacticsMCTS::FWorker::ApplyPlan(const FTacticsUnitPlan& Plan)
+{
+	FTacticsAI::ApplyPlanMove(State, Plan);
+
+	if (Plan.TargetSlot != INDEX_NONE)
+	{
+		// dadi campionati come in AUnitActions::AttackUnit
+		FSimAttackResult Result;
+		Rules.ApplyAttack(State, Plan.UnitSlot, Plan.TargetSlot, Random, Random, Result);
+	}
+
+	ReachSlot = INDEX_NONE; // la board è cambiata
+}
+
+float FTacticsMCTS::FWorker::Rollout(const FTacticsMCTSSettings& Settings)
+{
+	int32 Turns = 0;
+
+	while (Turns < Settings.RolloutTurns && State.IsSideAlive(true) && State.IsSideAlive(false))
+	{
+		if (FTacticsRules::IsTurnComplete(State))
+		{
+			FTacticsRules::EndTurn(State);
+			Turns++;
+			continue;
+		}
+
+		FTacticsUnitPlan Plan;
+		if (Settings.RolloutPolicy == EAIRolloutPolicy::Greedy)
+		{
+			// pochi candidati: la policy deve restare economica
+			PlanGenerator.GeneratePlans(State, 2, Plans);
+			Plan = Plans[0];
+		}
+		else if (!PickRandomPlan(Plan))
+		{
+			break;
+		}
+
+		ApplyPlan(Plan);
+	}
+
+	return GetReward();
+}
+
+bool FTacticsMCTS::FWorker::PickRandomPlan(FTacticsUnitPlan& OutPlan)
+{
+	// prima unità della squadra di turno che non ha finito
+	for (int32 Slot = 0; Slot < State.Units.Num(); Slot++)
+	{
+		const FSimUnit& Unit = State.Units[Slot];
+		if (Unit.bIsPlayer != State.bPlayerToMove || !Unit.IsAlive()) continue;
+		if (Unit.bHasMoved && Unit.bHasAttacked) continue;
+
+		OutPlan.UnitSlot = Slot;
+		OutPlan.MoveCell = Unit.CellIndex;
+		OutPlan.TargetSlot = INDEX_NONE;
+
+		if (!Unit.bHasMoved)
+		{
+			const FGridReachability& Moves = Rules.GetMoveReachability(State, Slot);
+			OutPlan.MoveCell = Moves.ReachedCells[Random.RandRange(0, Moves.ReachedCells.Num() - 1)];
+		}
+
+		if (!Unit.bHasAttacked)
+		{
+			Targets.Reset();
+			for (int32 TargetSlot = 0; TargetSlot < State.Units.Num(); TargetSlot++)
+			{
+				const FSimUnit& Target = State.Units[TargetSlot];
+				if (Target.bIsPlayer != Unit.bIsPlayer && Target.IsAlive() &&
+					FTacticsRules::IsInAttackRange(State.Board, Unit, OutPlan.MoveCell, Target.CellIndex))
+				{
+					Targets.Add(TargetSlot);
+				}
+			}
+
+			// se c'è un bersaglio si attacca sempre
+			if (Targets.Num() > 0)
+			{
+				OutPlan.TargetSlot = Targets[Random.RandRange(0, Targets.Num() - 1)];
+			}
+		}
+		return true;
+	}
+	return false;
+}
+
+float FTacticsMCTS::FWorker::GetReward() const
+{
+	if (!State.IsSideAlive(false)) return 0.f;
+	if (!State.IsSideAlive(true)) return 1.f;
+
+	// partita non finita: valutazione statica schiacciata in (0, 1)
+	return 1.f / (1.f + FMath::Exp(-FTacticsAI::Evaluate(State) / 100.f));
+}
+
+FTacticsMCTS::FTacticsMCTS() = default;
+FTacticsMCTS::~FTacticsMCTS() = default;
+
+bool FTacticsMCTS::FindBestPlan(const FTacticsGameState& State, const FTacticsMCTSSettings& Settings, const FMatchRandom& Random,
+	FTacticsUnitPlan& OutPlan)
+{
+	Stats = FTacticsMCTSStats();
+	if (FTacticsRules::IsTurnComplete(State)) return false;
+
+	const int32 NumThreads = Settings.NumThreads > 0
+		? Settings.NumThreads
+		: FTaskGraphInterface::Get().GetNumWorkerThreads() + 1; // + il thread chiamante
+
+	while (Workers.Num() < NumThreads)
+	{
+		Workers.Add(MakeUnique<FWorker>());
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double Deadline = StartTime + Settings.TimeBudgetSeconds;
+
+	ParallelFor(NumThreads, [this, &State, &Settings, &Random, Deadline](int32 WorkerIndex)
+	{
+		FWorker& Worker = *Workers[WorkerIndex];
+		Worker.Random = Random.Fork(Settings.StreamBase + WorkerIndex);
+		Worker.Run(State, Settings, Deadline);
+	});
+
+	Stats.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+	Stats.NumThreads = NumThreads;
+
+	// stessi figli della radice in ogni worker (stesso stato, stessa generazione)
+	const FWorker& First = *Workers[0];
+	const FWorker::FNode& Root = First.Nodes[0];
+	if (!Root.bExpanded || Root.NumChildren == 0) return false;
+
+	int32 BestChild = INDEX_NONE;
+	int32 BestVisits = -1;
+	float BestTotal = 0.f;
+
+	for (int32 Child = 0; Child < Root.NumChildren; Child++)
+	{
+		int32 Visits = 0;
+		float Total = 0.f;
+		for (int32 WorkerIndex = 0; WorkerIndex < NumThreads; WorkerIndex++)
+		{
+			const FWorker::FNode& Node = Workers[WorkerIndex]->Nodes[Root.FirstChild + Child];
+			Visits += Node.Visits;
+			Total += Node.TotalValue;
+		}
+
+		if (Visits > BestVisits)
+		{
+			BestVisits = Visits;
+			BestTotal = Total;
+			BestChild = Child;
+		}
+	}
+
+	for (int32 WorkerIndex = 0; WorkerIndex < NumThreads; WorkerIndex++)
+	{
+		Stats.Rollouts += Workers[WorkerIndex]->Rollouts;
+	}
+
+	OutPlan = First.Nodes[Root.FirstChild + BestChild].Plan;
+	Stats.BestVisits = BestVisits;
+	Stats.BestValue = BestVisits > 0 ? BestTotal / BestVisits : 0.f;
+	Stats.RolloutsPerSecond = Stats.ElapsedSeconds > 0.0 ? Stats.Rollouts / Stats.ElapsedSeconds : 0.0;
+	return true;
+}
@@ -0,0 +1,325 @@
+#include "TacticsSimulation.h"
+#include "GridManager.h"
+#include "MatchRandom.h"
+#include "Unit.h"
+
+uint64 FTacticsGameState::ComputeHash() const
+{
+	uint64 Result = bPlayerToMove ? FTacticsZobrist::PlayerToMove() : 0;
+
+	for (const FSimUnit& Unit : Units)
+	{
+		if (Unit.CellIndex != INDEX_NONE) Result ^= FTacticsZobrist::UnitCell(Unit.UnitId, Unit.CellIndex);
+		Result ^= FTacticsZobrist::UnitHealth(Unit.UnitId, Unit.Health);
+		if (Unit.bHasMoved) Result ^= FTacticsZobrist::UnitMoved(Unit.UnitId);
+		if (Unit.bHasAttacked) Result ^= FTacticsZobrist::UnitAttacked(Unit.UnitId);
+	}
+	return Result;
+}
+
+void FTacticsGameState::SetUnitCell(int32 Slot, int32 CellIndex)
+{
+	FSimUnit& Unit = Units[Slot];
+	if (Unit.CellIndex == CellIndex) return;
+
+	if (Unit.CellIndex != INDEX_NONE)
+	{
+		Board.ClearUnit(Unit.CellIndex);
+		Hash ^= FTacticsZobrist::UnitCell(Unit.UnitId, Unit.CellIndex);
+	}
+	if (CellIndex != INDEX_NONE)
+	{
+		Board.SetUnit(CellIndex, Unit.UnitId, Unit.bIsPlayer);
+		Hash ^= FTacticsZobrist::UnitCell(Unit.UnitId, CellIndex);
+	}
+	Unit.CellIndex = CellIndex;
+}
+
+void FTacticsGameState::SetUnitHealth(int32 Slot, int32 Health)
+{
+	FSimUnit& Unit = Units[Slot];
+	Hash ^= FTacticsZobrist::UnitHealth(Unit.UnitId, Unit.Health) ^ FTacticsZobrist::UnitHealth(Unit.UnitId, Health);
+	Unit.Health = Health;
+}
+
+void FTacticsGameState::SetHasMoved(int32 Slot, bool bValue)
+{
+	FSimUnit& Unit = Units[Slot];
+	if (Unit.bHasMoved == bValue) return;
+
+	Hash ^= FTacticsZobrist::UnitMoved(Unit.UnitId);
+	Unit.bHasMoved = bValue;
+}
+
+void FTacticsGameState::SetHasAttacked(int32 Slot, bool bValue)
+{
+	FSimUnit& Unit = Units[Slot];
+	if (Unit.bHasAttacked == bValue) return;
+
+	Hash ^= FTacticsZobrist::UnitAttacked(Unit.UnitId);
+	Unit.bHasAttacked = bValue;
+}
+
+void FTacticsGameState::SetPlayerToMove(bool bValue)
+{
+	if (bPlayerToMove == bValue) return;
+
+	Hash ^= FTacticsZobrist::PlayerToMove();
+	bPlayerToMove = bValue;
+}
+
+int32 FTacticsGameState::FindUnitSlot(int32 UnitId) const
+{
+	for (int32 Slot = 0; Slot < Units.Num(); Slot++)
+	{
+		if (Units[Slot].UnitId == UnitId) return Slot;
+	}
+	return INDEX_NONE;
+}
+
+int32 FTacticsGameState::FindUnitSlotAtCell(int32 CellIndex) const
+{
+	if (!Board.IsOccupied(CellIndex)) return INDEX_NONE;
+	return FindUnitSlot(Board.GetUnitId(CellIndex));
+}
+
+bool FTacticsGameState::IsSideAlive(bool bPlayer) const
+{
+	for (const FSimUnit& Unit : Units)
+	{
+		if (Unit.bIsPlayer == bPlayer && Unit.IsAlive()) return true;
+	}
+	return false;
+}
+
+void FTacticsGameState::Build(const AGridManager& Grid, const TArray<AUnit*>& PlayerUnits, const TArray<AUnit*>& AIUnits,
+	bool bInPlayerToMove, FTacticsGameState& Out)
+{
+	Out.Board = Grid.GetBoardState();
+	Out.StaticDistances = Grid.GetStaticDistances().Matches(Out.Board) ? &Grid.GetStaticDistances() : nullptr;
+	Out.bPlayerToMove = bInPlayerToMove;
+	Out.Units.Reset();
+
+	auto AddUnits = [&Grid, &Out](const TArray<AUnit*>& Source)
+	{
+		for (const AUnit* Unit : Source)
+		{
+			if (!IsValid(Unit) || Unit->UnitId == INDEX_NONE) continue;
+
+			FSimUnit& Sim = Out.Units.AddDefaulted_GetRef();
+			Sim.UnitId = Unit->UnitId;
+			Sim.CellIndex = Grid.GetUnitCellIndex(Unit);
+			Sim.Health = Unit->Health;
+			Sim.MovementRange = Unit->MovementRange;
+			Sim.AttackRange = Unit->AttackRange;
+			Sim.MinDamage = Unit->MinDamage;
+			Sim.MaxDamage = Unit->MaxDamage;
+			Sim.bIsPlayer = Unit->bIsPlayerUnit;
+			Sim.bIsRanged = Unit->IsSniper();
+			Sim.bHasMoved = Unit->bHasMovedThisTurn;
+			Sim.bHasAttacked = Unit->bHasAttackedThisTurn;
+		}
+	};
+
+	AddUnits(PlayerUnits);
+	AddUnits(AIUnits);
+
+	Out.Hash = Out.ComputeHash();
+}
+
+const FGridReachability& FTacticsRules::GetMoveReachability(const FTacticsGameState& State, int32 UnitSlot)
+{
+	// niente cache sulla Revision: copie diverse dello stato possono avere la stessa Revision
+	const FSimUnit& Unit = State.Units[UnitSlot];
+	FGridPathfinder::ComputeReachability(State.Board, Unit.CellIndex, Unit.MovementRange, Reach);
+	return Reach;
+}
+
+bool FTacticsRules::CanMove(const FTacticsGameState& State, int32 UnitSlot, int32 TargetCell)
+{
+	if (!State.Units.IsValidIndex(UnitSlot)) return false;
+
+	const FSimUnit& Unit = State.Units[UnitSlot];
+	if (!Unit.IsAlive() || Unit.bHasMoved || Unit.bIsPlayer != State.bPlayerToMove) return false;
+	if (TargetCell < 0 || TargetCell >= State.Board.NumCells()) return false;
+
+	// troppo lontano anche senza unità in mezzo: niente BFS
+	if (State.StaticDistances && State.StaticDistances->Get(Unit.CellIndex, TargetCell) > Unit.MovementRange) return false;
+
+	// percorso libero entro MovementRange (restare fermi conta come mossa): serve solo il sì/no,
+	// quindi flood fill a bit invece della BFS con distanze e predecessori
+	return Bitboard.IsReachableWithin(State.Board, Unit.CellIndex, TargetCell, Unit.MovementRange);
+}
+
+bool FTacticsRules::ApplyMove(FTacticsGameState& State, int32 UnitSlot, int32 TargetCell)
+{
+	if (!CanMove(State, UnitSlot, TargetCell)) return false;
+
+	ApplyMoveUnchecked(State, UnitSlot, TargetCell);
+	return true;
+}
+
+void FTacticsRules::ApplyMoveUnchecked(FTacticsGameState& State, int32 UnitSlot, int32 TargetCell)
+{
+	State.SetUnitCell(UnitSlot, TargetCell);
+	State.SetHasMoved(UnitSlot, true);
+}
+
+bool FTacticsRules::IsInAttackRange(const FGridBoardState& Board, const FSimUnit& Attacker, int32 FromCell, int32 TargetCell)
+{
+	const int32 Distance = Board.GetDistance(FromCell, TargetCell);
+	if (Distance > Attacker.AttackRange) return false;
+
+	// il corpo a corpo colpisce solo le celle adiacenti
+	return Attacker.bIsRanged || Distance == 1;
+}
+
+bool FTacticsRules::CanAttack(const FTacticsGameState& State, int32 AttackerSlot, int32 TargetSlot)
+{
+	if (!State.Units.IsValidIndex(AttackerSlot) || !State.Units.IsValidIndex(TargetSlot)) return false;
+
+	const FSimUnit& Attacker = State.Units[AttackerSlot];
+	const FSimUnit& Target = State.Units[TargetSlot];
+
+	if (!Attacker.IsAlive() || !Attacker.CanAttack() || Attacker.bIsPlayer != State.bPlayerToMove) return false;
+	if (!Target.IsAlive() || Target.bIsPlayer == Attacker.bIsPlayer) return false;
+
+	return IsInAttackRange(State.Board, Attacker, Attacker.CellIndex, Target.CellIndex);
+}
+
+bool FTacticsRules::WouldCounterattack(const FTacticsGameState& State, int32 AttackerSlot, int32 TargetSlot, int32 Damage)
+{
+	const FSimUnit& Attacker = State.Units[AttackerSlot];
+	const FSimUnit& Target = State.Units[TargetSlot];
+
+	const int32 Distance = State.Board.GetDistance(Attacker.CellIndex, Target.CellIndex);
+
+	// contrattacco solo a distanza 1 e se il bersaglio sopravvive e può ancora attaccare
+	return Distance == 1 && Target.Health - Damage > 0 && !Target.bHasAttacked;
+}
+
+bool FTacticsRules::ApplyAttack(FTacticsGameState& State, int32 AttackerSlot, int32 TargetSlot,
+	FPcg32& DamageRandom, FPcg32& CounterRandom, FSimAttackResult& OutResult)
+{
+	if (!CanAttack(State, AttackerSlot, TargetSlot)) return false;
+
+	const FSimUnit& Attacker = State.Units[AttackerSlot];
+	const int32 Damage = DamageRandom.RandRange(Attacker.MinDamage, Attacker.MaxDamage);
+
+	const int32 CounterDamage = WouldCounterattack(State, AttackerSlot, TargetSlot, Damage)
+		? CounterRandom.RandRange(CounterMinDamage, CounterMaxDamage)
+		: 0;
+
+	return ApplyAttackWithRolls(State, AttackerSlot, TargetSlot, Damage, CounterDamage, OutResult);
+}
+
+bool FTacticsRules::ApplyAttackWithRolls(FTacticsGameState& State, int32 AttackerSlot, int32 TargetSlot,
+	int32 Damage, int32 CounterDamage, FSimAttackResult& OutResult)
+{
+	OutResult = FSimAttackResult();
+	if (!CanAttack(State, AttackerSlot, TargetSlot)) return false;
+
+	const bool bCounter = WouldCounterattack(State, AttackerSlot, TargetSlot, Damage);
+
+	State.SetUnitHealth(TargetSlot, State.Units[TargetSlot].Health - Damage);
+	OutResult.Damage = Damage;
+
+	if (State.Units[TargetSlot].Health <= 0)
+	{
+		State.SetUnitCell(TargetSlot, INDEX_NONE);
+		OutResult.bTargetKilled = true;
+	}
+
+	if (bCounter)
+	{
+		State.SetUnitHealth(AttackerSlot, State.Units[AttackerSlot].Health - CounterDamage);
+		OutResult.bCounterattack = true;
+		OutResult.CounterDamage = CounterDamage;
+
+		if (State.Units[AttackerSlot].Health <= 0)
+		{
+			State.SetUnitCell(AttackerSlot, INDEX_NONE);
+			OutResult.bAttackerKilled = true;
+		}
+	}
+
+	State.SetHasAttacked(AttackerSlot, true);
+	return true;
+}
+
+void FTacticsRules::EndTurn(FTacticsGameState& State)
+{
+	State.SetPlayerToMove(!State.bPlayerToMove);
+	State.TurnNumber++;
+
+	for (int32 Slot = 0; Slot < State.Units.Num(); Slot++)
+	{
+		if (State.Units[Slot].bIsPlayer == State.bPlayerToMove)
+		{
+			State.SetHasMoved(Slot, false);
+			State.SetHasAttacked(Slot, false);
+		}
+	}
+}
+
+bool FTacticsRules::IsTurnComplete(const FTacticsGameState& State)
+{
+	for (const FSimUnit& Unit : State.Units)
+	{
+		if (Unit.bIsPlayer == State.bPlayerToMove && Unit.IsAlive() && (!Unit.bHasMoved || !Unit.bHasAttacked))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void FTacticsRules::LegalActions(const FTacticsGameState& State, TArray<FSimAction>& OutActions)
+{
+	OutActions.Reset();
+
+	for (int32 Slot = 0; Slot < State.Units.Num(); Slot++)
+	{
+		const FSimUnit& Unit = State.Units[Slot];
+		if (Unit.bIsPlayer != State.bPlayerToMove || !Unit.IsAlive()) continue;
+
+		if (!Unit.bHasMoved)
+		{
+			const FGridReachability& Moves = GetMoveReachability(State, Slot);
+			for (int32 Cell : Moves.ReachedCells)
+			{
+				if (Cell != Unit.CellIndex) OutActions.Add(FSimAction::Move(Slot, Cell));
+			}
+		}
+
+		if (Unit.CanAttack())
+		{
+			for (int32 TargetSlot = 0; TargetSlot < State.Units.Num(); TargetSlot++)
+			{
+				if (CanAttack(State, Slot, TargetSlot)) OutActions.Add(FSimAction::Attack(Slot, TargetSlot));
+			}
+		}
+	}
+
+	OutActions.Add(FSimAction::EndTurn());
+}
+
+bool FTacticsRules::ApplyAction(FTacticsGameState& State, const FSimAction& Action, FPcg32& DamageRandom, FPcg32& CounterRandom)
+{
+	switch (Action.Type)
+	{
+	case ESimActionType::Move:
+		return ApplyMove(State, Action.UnitSlot, Action.Target);
+
+	case ESimActionType::Attack:
+	{
+		FSimAttackResult Result;
+		return ApplyAttack(State, Action.UnitSlot, Action.Target, DamageRandom, CounterRandom, Result);
+	}
+
+	case ESimActionType::EndTurn:
+	default:
+		EndTurn(State);
+		return true;
+	}
+}
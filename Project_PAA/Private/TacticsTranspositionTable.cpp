@@ -0,0 +1,99 @@
+#include "TacticsTranspositionTable.h"
+
+namespace
+{
+	FORCEINLINE uint64 PackData0(const FTacticsTTEntry& Entry, uint8 Age)
+	{
+		uint32 ValueBits;
+		FMemory::Memcpy(&ValueBits, &Entry.Value, sizeof(ValueBits));
+
+		return static_cast<uint64>(ValueBits)
+			| (static_cast<uint64>(FMath::Clamp(Entry.Depth, 0, 255)) << 32)
+			| (static_cast<uint64>(Entry.Bound) << 40)
+			| (static_cast<uint64>(Age) << 48);
+	}
+
+	// +1 su ogni campo: INDEX_NONE diventa 0
+	FORCEINLINE uint64 PackData1(const FTacticsUnitPlan& Plan)
+	{
+		return static_cast<uint64>(static_cast<uint8>(Plan.UnitSlot + 1))
+			| (static_cast<uint64>(static_cast<uint8>(Plan.TargetSlot + 1)) << 8)
+			| (static_cast<uint64>(static_cast<uint32>(Plan.MoveCell + 1)) << 16);
+	}
+
+	FORCEINLINE int32 UnpackDepth(uint64 Data0) { return static_cast<int32>((Data0 >> 32) & 0xff); }
+	FORCEINLINE uint8 UnpackAge(uint64 Data0) { return static_cast<uint8>(Data0 >> 48); }
+}
+
+FTacticsTranspositionTable::FTacticsTranspositionTable(int32 SizeLog2)
+{
+	Resize(SizeLog2);
+}
+
+void FTacticsTranspositionTable::Resize(int32 SizeLog2)
+{
+	const uint64 NumSlots = 1ull << FMath::Clamp(SizeLog2, 4, 26);
+	if (Slots && Mask + 1 == NumSlots) return;
+
+	Slots = MakeUnique<FSlot[]>(NumSlots);
+	Mask = NumSlots - 1;
+	Age = 1;
+}
+
+void FTacticsTranspositionTable::Clear()
+{
+	for (uint64 i = 0; i <= Mask; i++)
+	{
+		Slots[i].Check.store(0, std::memory_order_relaxed);
+		Slots[i].Data0.store(0, std::memory_order_relaxed);
+		Slots[i].Data1.store(0, std::memory_order_relaxed);
+	}
+	Age = 1;
+}
+
+void FTacticsTranspositionTable::NewSearch()
+{
+	// 0 è riservato agli slot mai scritti
+	Age = Age == MAX_uint8 ? 1 : Age + 1;
+}
+
+bool FTacticsTranspositionTable::Probe(uint64 Key, FTacticsTTEntry& OutEntry) const
+{
+	const FSlot& Slot = Slots[Key & Mask];
+	const uint64 Check = Slot.Check.load(std::memory_order_relaxed);
+	const uint64 Data0 = Slot.Data0.load(std::memory_order_relaxed);
+	const uint64 Data1 = Slot.Data1.load(std::memory_order_relaxed);
+
+	// altra posizione o scrittura concorrente a metà
+	if ((Check ^ Data0 ^ Data1) != Key) return false;
+
+	const ETacticsBound Bound = static_cast<ETacticsBound>((Data0 >> 40) & 0x3);
+	if (Bound == ETacticsBound::None) return false;
+
+	const uint32 ValueBits = static_cast<uint32>(Data0);
+	FMemory::Memcpy(&OutEntry.Value, &ValueBits, sizeof(ValueBits));
+	OutEntry.Depth = UnpackDepth(Data0);
+	OutEntry.Bound = Bound;
+
+	OutEntry.BestPlan.UnitSlot = static_cast<int32>(Data1 & 0xff) - 1;
+	OutEntry.BestPlan.TargetSlot = static_cast<int32>((Data1 >> 8) & 0xff) - 1;
+	OutEntry.BestPlan.MoveCell = static_cast<int32>(static_cast<uint32>(Data1 >> 16)) - 1;
+	OutEntry.BestPlan.OrderScore = 0;
+	return true;
+}
+
+void FTacticsTranspositionTable::Store(uint64 Key, const FTacticsTTEntry& Entry)
+{
+	FSlot& Slot = Slots[Key & Mask];
+
+	// nella stessa ricerca vince la voce più profonda; quelle vecchie si sostituiscono sempre
+	const uint64 OldData0 = Slot.Data0.load(std::memory_order_relaxed);
+	if (UnpackAge(OldData0) == Age && UnpackDepth(OldData0) > Entry.Depth) return;
+
+	const uint64 Data0 = PackData0(Entry, Age);
+	const uint64 Data1 = PackData1(Entry.BestPlan);
+
+	Slot.Data0.store(Data0, std::memory_order_relaxed);
+	Slot.Data1.store(Data1, std::memory_order_relaxed);
+	Slot.Check.store(Key ^ Data0 ^ Data1, std::memory_order_relaxed);
+}
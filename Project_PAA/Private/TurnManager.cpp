@@ -3,9 +3,10 @@
 #include "Unit.h"
 #include "GridManager.h"
 #include "UnitActions.h"
-#include "Kismet/GameplayStatics.h"
+#include "Async/Async.h"
 
 ATurnManager::ATurnManager()
+	: Planner(MakeShared<FAIPlanner, ESPMode::ThreadSafe>())
 {
 	PrimaryActorTick.bCanEverTick = false;
 }
@@ -13,7 +14,8 @@ ATurnManager::ATurnManager()
 void ATurnManager::BeginPlay()
 {
 	Super::BeginPlay();
-	// Initialization code if needed
+
+	Planner->TranspositionTable.Resize(TranspositionTableSizeLog2);
 }
 
 void ATurnManager::StartActionPhase(AMyGameMode* GameMode)
@@ -35,229 +37,240 @@ void ATurnManager::StartActionPhase(AMyGameMode* GameMode)
 
 void ATurnManager::EndTurn(AMyGameMode* GameMode)
 {
-	
+	// stesso cambio turno del pulsante: regole condivise e avvio dell'IA dal GameMode
 	if (!GameMode) return;
-	//HideActionWidget();
-
-	GameMode->bIsPlayerTurn = !GameMode->bIsPlayerTurn;
-    
-	if (GameMode->bIsPlayerTurn)
-	{
-		// Reset player units
-		for (AUnit* Unit : GameMode->PlayerUnits)
-		{
-			Unit->bHasMovedThisTurn = false;
-		}
-	}
-	else
-	{
-		ExecuteAITurn(GameMode);
-	}
+	GameMode->EndTurn();
 }
 
 void ATurnManager::ExecuteAITurn(AMyGameMode* GameMode)
 {
-	if (!GameMode) return;
+	if (!GameMode || !GameMode->UnitActions || !GameMode->GridManager || bAITurnInProgress) return;
+
+	// Un'unità alla volta: i dadi reali cambiano lo stato, quindi si ripianifica dopo ogni azione
+	bAITurnInProgress = true;
+	AITurnGameMode = GameMode;
+	AIActedUnitIds.Reset();
+	AIStepsLeft = GameMode->AIUnits.Num();
+	RunNextAIStep();
+}
 
-	// 1. Movement Phase
-	for (AUnit* AIUnit : GameMode->AIUnits)
+void ATurnManager::RunNextAIStep()
+{
+	AMyGameMode* GameMode = AITurnGameMode.Get();
+	if (!GameMode || AIStepsLeft <= 0)
 	{
-		if (!AIUnit || AIUnit->bHasMovedThisTurn) continue;
-
-		AUnit* Target = FindNearestEnemy(AIUnit);
-		if (!Target) continue;
-
-		// Calculate move direction (simple approach)
-		FVector2D Direction = (Target->GetGridPosition() - AIUnit->GetGridPosition()).GetSafeNormal();
-		FVector2D TargetPos = AIUnit->GetGridPosition() + (Direction * AIUnit->MovementRange);
-
-		if (GameMode->UnitActions->MoveUnit(AIUnit, TargetPos))
-		{
-			UE_LOG(LogTemp, Warning, TEXT("AI %s moved to (%.0f,%.0f)"), 
-				*AIUnit->GetName(), TargetPos.X, TargetPos.Y);
-		}
+		FinishAITurn();
+		return;
 	}
 
-	// 2. Attack Phase
-	for (AUnit* AIUnit : GameMode->AIUnits)
+	FTacticsGameState State;
+	if (!GameMode->BuildSimulationState(State))
 	{
-		if (!AIUnit || AIUnit->bHasAttackedThisTurn) continue;
-
-		AUnit* Target = FindNearestEnemy(AIUnit);
-		if (!Target) continue;
+		FinishAITurn();
+		return;
+	}
 
-		if (GameMode->UnitActions->AttackUnit(AIUnit, Target))
+	// chi ha già agito senza attaccare ha comunque finito
+	for (int32 Slot = 0; Slot < State.Units.Num(); Slot++)
+	{
+		if (AIActedUnitIds.Contains(State.Units[Slot].UnitId))
 		{
-			UE_LOG(LogTemp, Warning, TEXT("AI %s attacked %s"), 
-				*AIUnit->GetName(), *Target->GetName());
+			State.SetHasMoved(Slot, true);
+			State.SetHasAttacked(Slot, true);
 		}
 	}
 
-	// 3. End AI Turn
-	FTimerHandle TimerHandle;
-	GetWorld()->GetTimerManager().SetTimer(TimerHandle, [GameMode]()
+	if (FTacticsRules::IsTurnComplete(State))
 	{
-		GameMode->EndTurn();
-	}, 2.0f, false); // 2 second delay for visibility
-}
+		FinishAITurn();
+		return;
+	}
 
-void ATurnManager::ProcessAIMovement(AMyGameMode* GameMode)
-{
-	if (!GameMode || !GameMode->GridManager || !GameMode->UnitActions) return;
+	// lo stato è una copia: il worker non tocca attori né GridManager.
+	// Le distanze statiche dello stato puntano nello snapshot, che i task tengono vivo
+	// anche se il livello chiude o gli ostacoli cambiano durante la ricerca
+	const FGridStaticDistancesSnapshot StaticDistances = GameMode->GridManager->GetStaticDistancesSnapshot();
+	State.StaticDistances = StaticDistances.Get();
 
-	for (AUnit* AIUnit : GameMode->AIUnits)
+	const FAIPlanRequest Request = MakeAIPlanRequest(GameMode);
+	TWeakObjectPtr<ATurnManager> WeakThis(this);
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [SharedPlanner = Planner, Request, State, StaticDistances, WeakThis]()
 	{
-		
-		if (!AIUnit || AIUnit->bHasMovedThisTurn) continue;
-		FVector2D BestPosition;
-		if (FindMovePositionForAI(AIUnit, BestPosition))
-		{
-			AIUnit->SetGridPosition(BestPosition);
-			AIUnit->bHasMovedThisTurn = true;
-			UE_LOG(LogTemp, Warning, TEXT("AI %s moved to [%.0f,%.0f]"), 
-				*AIUnit->GetName(), BestPosition.X, BestPosition.Y);
-		}
-		
-		// Find closest player unit
-		AUnit* ClosestEnemy = nullptr;
-		float MinDistance = MAX_FLT;
-        
-		for (AUnit* PlayerUnit : GameMode->PlayerUnits)
+		FTacticsUnitPlan Plan;
+		const bool bFound = FindAIPlan(*SharedPlanner, Request, State, Plan);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, State, StaticDistances, bFound, Plan]()
 		{
-			float Distance = FVector2D::Distance(AIUnit->GetGridPosition(), 
-											   PlayerUnit->GetGridPosition());
-			if (Distance < MinDistance)
+			if (ATurnManager* Self = WeakThis.Get())
 			{
-				MinDistance = Distance;
-				ClosestEnemy = PlayerUnit;
+				Self->OnAIPlanReady(State, bFound, Plan);
 			}
-		}
+		});
+	});
+}
 
-		// Move toward closest enemy
-		if (ClosestEnemy)
-		{
-			// Simple movement toward enemy (implement proper pathfinding here)
-			FVector2D Direction = (ClosestEnemy->GetGridPosition() - AIUnit->GetGridPosition()).GetSafeNormal();
-			FVector2D TargetPos = AIUnit->GetGridPosition() + (Direction * AIUnit->MovementRange);
-            
-			GameMode->UnitActions->MoveUnit(AIUnit, TargetPos);
-		}
+void ATurnManager::OnAIPlanReady(const FTacticsGameState& State, bool bFound, const FTacticsUnitPlan& Plan)
+{
+	AMyGameMode* GameMode = AITurnGameMode.Get();
+	if (!GameMode || !GameMode->GridManager || !bFound)
+	{
+		FinishAITurn();
+		return;
 	}
+
+	// la board è cambiata durante la ricerca: il piano non vale più, si ripianifica lo stesso passo
+	if (State.Board.Revision != GameMode->GridManager->GetBoardState().Revision)
+	{
+		RunNextAIStep();
+		return;
 	}
 
+	AIStepsLeft--;
+	AIActedUnitIds.Add(State.Units[Plan.UnitSlot].UnitId);
+	if (!ExecuteAIPlan(GameMode, State, Plan))
+	{
+		FinishAITurn();
+		return;
+	}
 
-bool ATurnManager::FindMovePositionForAI(AUnit* AIUnit, FVector2D& OutBestPosition)
-{
-	if (!AIUnit || !AIUnit->GetWorld()) return false;
+	RunNextAIStep();
+}
 
-	AUnit* NearestEnemy = FindNearestEnemy(AIUnit);
-	if (!NearestEnemy) return false;
+void ATurnManager::FinishAITurn()
+{
+	bAITurnInProgress = false;
 
-	AGridManager* GridManager = Cast<AGridManager>(
-		UGameplayStatics::GetActorOfClass(AIUnit->GetWorld(), AGridManager::StaticClass()));
-	if (!GridManager) return false;
+	AMyGameMode* GameMode = AITurnGameMode.Get();
+	AITurnGameMode.Reset();
+	if (!GameMode) return;
 
+	// End AI Turn
+	FTimerHandle TimerHandle;
+	GetWorld()->GetTimerManager().SetTimer(TimerHandle, [GameMode]()
+	{
+		GameMode->EndTurn();
+	}, 2.0f, false); // 2 second delay for visibility
+}
 
-	// Create temporary obstacle map that matches our pathfinding needs
-	TArray<TArray<bool>> TempObstacleMap;
-	TempObstacleMap.SetNum(GridManager->GetGridSizeX());
-    
-	for (int32 X = 0; X < GridManager->GetGridSizeX(); X++)
+ATurnManager::FAIPlanRequest ATurnManager::MakeAIPlanRequest(AMyGameMode* GameMode)
+{
+	FAIPlanRequest Request;
+	Request.Mode = AIMode;
+
+	Request.MCTSSettings.TimeBudgetSeconds = MCTSBudgetMs * 0.001;
+	Request.MCTSSettings.NumThreads = MCTSThreads;
+	Request.MCTSSettings.RolloutPolicy = MCTSRolloutPolicy;
+	Request.MCTSSettings.RolloutTurns = MCTSRolloutTurns;
+	Request.MCTSSettings.MaxMoveCandidates = AIMaxMoveCandidates;
+	if (AIMode == EAIMode::MonteCarlo)
 	{
-		TempObstacleMap[X].SetNum(GridManager->GetGridSizeY());
-		for (int32 Y = 0; Y < GridManager->GetGridSizeY(); Y++)
-		{
-			if (AGridCell* Cell = GridManager->GetCellAtPosition(FVector2D(X, Y)))
-			{
-				// Mark cell as obstructed if it's an obstacle OR occupied by another unit
-				TempObstacleMap[X][Y] = Cell->IsObstacle() || (Cell->IsOccupied() && !(X == AIUnit->GetGridPosition().X && Y == AIUnit->GetGridPosition().Y));
-			}
-			else
-			{
-				TempObstacleMap[X][Y] = true; // Invalid cells are always obstructed
-			}
-		}
+		Request.MCTSSettings.StreamBase = 64 * MCTSSearchCount++; // stream nuovi ad ogni ricerca, riproducibili col seed
+		Request.Random = GameMode->GetMatchRandom();
 	}
 
-	// Use existing AStarPathfind with our custom obstacle map
-	TArray<FVector2D> Path = GridManager->AStarPathfind(
-		AIUnit->GetGridPosition(),
-		NearestEnemy->GetGridPosition(),
-		AIUnit->MovementRange
-	
-	);
+	Request.AISettings.TimeBudgetSeconds = AISearchBudgetMs * 0.001;
+	Request.AISettings.MaxDepth = AISearchMaxDepth;
+	Request.AISettings.MaxMoveCandidates = AIMaxMoveCandidates;
+	Request.bUseTranspositionTable = bUseTranspositionTable;
 
-	// Find farthest reachable point along path
-	int32 MovesRemaining = AIUnit->MovementRange;
-	FVector2D CurrentPos = AIUnit->GetGridPosition();
-	OutBestPosition = CurrentPos;
+	// copiati: il worker non legge il GridManager
+	BuildApproachFields(GameMode, Request.ApproachFields);
+	return Request;
+}
 
-	for (int32 i = 1; i < Path.Num() && MovesRemaining > 0; i++)
+bool ATurnManager::FindAIPlan(FAIPlanner& InPlanner, const FAIPlanRequest& Request, const FTacticsGameState& State, FTacticsUnitPlan& OutPlan)
+{
+	if (Request.Mode == EAIMode::MonteCarlo)
 	{
-		FVector2D NextPos = Path[i];
-		int32 Cost = FMath::Abs(NextPos.X - CurrentPos.X) + 
-					FMath::Abs(NextPos.Y - CurrentPos.Y);
-        
-		if (Cost <= MovesRemaining && GridManager->IsCellFree(NextPos))
-		{
-			OutBestPosition = NextPos;
-			MovesRemaining -= Cost;
-			CurrentPos = NextPos;
-		}
-		else
-		{
-			break;
-		}
+		if (!InPlanner.MCTSSearch.FindBestPlan(State, Request.MCTSSettings, Request.Random, OutPlan)) return false;
+
+		const FTacticsMCTSStats& Stats = InPlanner.MCTSSearch.GetLastStats();
+		UE_LOG(LogTemp, Log, TEXT("AI MCTS: %d rollouts on %d threads in %.2f ms (%.0f rollouts/s), best visits %d, value %.2f"),
+			Stats.Rollouts, Stats.NumThreads, Stats.ElapsedSeconds * 1000.0, Stats.RolloutsPerSecond,
+			Stats.BestVisits, Stats.BestValue);
+		return true;
 	}
 
-	return OutBestPosition != AIUnit->GetGridPosition();
+	InPlanner.Search.SetTranspositionTable(Request.bUseTranspositionTable ? &InPlanner.TranspositionTable : nullptr);
+	InPlanner.Search.SetApproachFields(&Request.ApproachFields);
+	const bool bFound = InPlanner.Search.FindBestPlan(State, Request.AISettings, OutPlan);
+	InPlanner.Search.SetApproachFields(nullptr);
+	if (!bFound) return false;
+
+	const FTacticsAIStats& Stats = InPlanner.Search.GetLastStats();
+	UE_LOG(LogTemp, Log, TEXT("AI search: depth %d, %d nodes (%d from table), %.2f ms, value %.1f%s"),
+		Stats.CompletedDepth, Stats.Nodes, Stats.TableHits, Stats.ElapsedSeconds * 1000.0, Stats.BestValue,
+		Stats.bTimedOut ? TEXT(" (budget reached)") : TEXT(""));
+	return true;
 }
 
-void ATurnManager::ProcessAIAttacks(AMyGameMode* GameMode)
+void ATurnManager::BuildApproachFields(AMyGameMode* GameMode, TArray<FTacticsApproachField>& OutFields)
 {
-	if (!GameMode || !GameMode->UnitActions) return;
+	OutFields.Reset();
 
+	// destinazioni verso le celle d'attacco: un campo per tipo di unità IA, riparato dal
+	// GridManager solo dove la board cambia
+	AGridManager* GridManager = GameMode->GridManager;
+	const FGridBoardState& Board = GridManager->GetBoardState();
 	for (AUnit* AIUnit : GameMode->AIUnits)
 	{
-		// Simple AI attack logic - attacks first available target
-		for (AUnit* PlayerUnit : GameMode->PlayerUnits)
+		if (!IsValid(AIUnit)) continue;
+
+		const bool bRanged = AIUnit->IsSniper();
+		const bool bKnown = OutFields.ContainsByPredicate([AIUnit, bRanged](const FTacticsApproachField& Approach)
 		{
-			if (GameMode->UnitActions->AttackUnit(AIUnit, PlayerUnit))
+			return Approach.AttackRange == AIUnit->AttackRange && Approach.bRanged == bRanged;
+		});
+		if (bKnown) continue;
+
+		const FGridDistanceField& Field = GridManager->GetAttackDistanceField(!AIUnit->bIsPlayerUnit, AIUnit->AttackRange, bRanged);
+		FTacticsApproachField& Approach = OutFields.AddDefaulted_GetRef();
+		Approach.bTargetPlayerTeam = !AIUnit->bIsPlayerUnit;
+		Approach.AttackRange = AIUnit->AttackRange;
+		Approach.bRanged = bRanged;
+		Approach.BoardRevision = Board.Revision;
+		Approach.Distance = Field.Distance;
+
+		// chi muove parte da una cella occupata, che il campo non attraversa
+		for (AUnit* Mover : GameMode->AIUnits)
+		{
+			const int32 Cell = IsValid(Mover) ? GridManager->GetUnitCellIndex(Mover) : INDEX_NONE;
+			if (Cell != INDEX_NONE)
 			{
-				break; // Attack once per unit
+				Approach.Distance[Cell] = Field.GetDistanceFromBlocked(Board, Cell);
 			}
 		}
 	}
 }
 
-AUnit* ATurnManager::FindNearestEnemy(AUnit* AIUnit)
+bool ATurnManager::ExecuteAIPlan(AMyGameMode* GameMode, const FTacticsGameState& State, const FTacticsUnitPlan& Plan)
 {
-	if (!AIUnit) return nullptr;
+	AGridManager* GridManager = GameMode->GridManager;
+	AUnit* AIUnit = GridManager->GetRegisteredUnit(State.Units[Plan.UnitSlot].UnitId);
+	if (!IsValid(AIUnit)) return false;
+
+	if (Plan.MoveCell != State.Units[Plan.UnitSlot].CellIndex)
+	{
+		const FIntPoint Cell = GridManager->GetCellCoord(Plan.MoveCell);
+		const FVector2D TargetPos(Cell.X, Cell.Y);
 
-	// Properly get GameMode from the world
-	AMyGameMode* GameMode = Cast<AMyGameMode>(GetWorld()->GetAuthGameMode());
-	if (!GameMode || !GameMode->PlayerUnits.Num()) return nullptr;
+		if (!GameMode->UnitActions->MoveUnit(AIUnit, TargetPos)) return false;
 
-	AUnit* NearestEnemy = nullptr;
-	float MinDistance = TNumericLimits<float>::Max();
+		UE_LOG(LogTemp, Warning, TEXT("AI %s moved to (%.0f,%.0f)"),
+			*AIUnit->GetName(), TargetPos.X, TargetPos.Y);
+	}
 
-	for (AUnit* PlayerUnit : GameMode->PlayerUnits)
+	if (Plan.TargetSlot != INDEX_NONE)
 	{
-		if (!PlayerUnit) continue;
+		AUnit* Target = GridManager->GetRegisteredUnit(State.Units[Plan.TargetSlot].UnitId);
+		if (!IsValid(Target)) return false;
 
-		float Distance = FVector2D::Distance(
-			AIUnit->GetGridPosition(),
-			PlayerUnit->GetGridPosition()
-		);
+		const FString TargetName = Target->GetName();
+		if (!GameMode->UnitActions->AttackUnit(AIUnit, Target)) return false;
 
-		if (Distance < MinDistance)
-		{
-			MinDistance = Distance;
-			NearestEnemy = PlayerUnit;
-		}
+		UE_LOG(LogTemp, Warning, TEXT("AI %s attacked %s"), *AIUnit->GetName(), *TargetName);
 	}
-
-	return NearestEnemy;
+	return true;
 }
 
 // Add to TurnManager.cpp
@@ -265,18 +278,10 @@ void ATurnManager::CheckTurnCompletion(AMyGameMode* GameMode)
 {
 	if (!GameMode) return;
 
-	bool bAllUnitsActed = true;
-	TArray<AUnit*>& CurrentUnits = GameMode->bIsPlayerTurn ? GameMode->PlayerUnits : GameMode->AIUnits;
-    
-	for (AUnit* Unit : CurrentUnits)
-	{
-		if (Unit && Unit->Health > 0 && 
-		   (!Unit->bHasMovedThisTurn || !Unit->bHasAttackedThisTurn))
-		{
-			bAllUnitsActed = false;
-			break;
-		}
-	}
+	FTacticsGameState State;
+	if (!GameMode->BuildSimulationState(State)) return;
+
+	const bool bAllUnitsActed = FTacticsRules::IsTurnComplete(State);
 
 	if (bAllUnitsActed)
 	{
@@ -13,11 +13,11 @@ AUnit::AUnit()
 	UnitMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("UnitMesh"));
 	RootComponent = UnitMesh;
 	
-	// Impostazioni di collisione (queste servono comunque!)
-	UnitMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-	UnitMesh->SetCollisionObjectType(ECC_Pawn);
-	UnitMesh->SetCollisionResponseToAllChannels(ECR_Block);
-	UnitMesh->SetCollisionResponseToChannel(ECC_Visibility, ECR_Block);
+	// niente collisione: il click sull'unità arriva dal GridManager come click sulla sua cella
+	UnitMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	// la cella trova l'unità dal registro del GridManager, non servono overlap
+	UnitMesh->SetGenerateOverlapEvents(false);
 
 	static ConstructorHelpers::FObjectFinder<UStaticMesh> MeshAsset(TEXT("/Engine/BasicShapes/Cube.Cube"));
 	if (MeshAsset.Succeeded())
@@ -30,10 +30,6 @@ AUnit::AUnit()
 void AUnit::BeginPlay()
 {
 	Super::BeginPlay();
-	if (UnitMesh)
-	{
-		UnitMesh->OnClicked.AddDynamic(this, &AUnit::OnClicked);
-	}
 }
 
 void AUnit::SetSelected(bool bSelected)
@@ -51,20 +47,15 @@ void AUnit::SetGridPosition(FVector2D NewPosition)
 	AGridManager* GridManager = GetGridManager();
 	if (!GridManager) return;
 
-	if (AGridCell* CurrentCell = GridManager->GetCellAtPosition(GridPosition))
-	{
-		if (CurrentCell->GetUnit() == this)
-		{
-			CurrentCell->SetUnit(nullptr);
-		}
-	}
-
 	GridPosition = NewPosition;
 
-	if (AGridCell* NewCell = GridManager->GetCellAtPosition(NewPosition))
+	// SetCellUnit libera anche la cella precedente (registro unità -> cella)
+	const int32 NewX = FMath::RoundToInt(NewPosition.X);
+	const int32 NewY = FMath::RoundToInt(NewPosition.Y);
+	if (GridManager->IsValidCoord(NewX, NewY))
 	{
-		NewCell->SetUnit(this);
-		SetActorLocation(GridManager->GetCellWorldPosition(NewPosition.X, NewPosition.Y));
+		GridManager->SetCellUnit(NewX, NewY, this);
+		SetActorLocation(GridManager->GetCellWorldPosition(NewX, NewY));
 	}
 }
 
@@ -139,25 +130,11 @@ void AUnit::SetAsPlayerUnit(bool bIsPlayer)
 	ApplyTeamMaterials(bIsPlayer);
 }
 
-void AUnit::OnClicked(UPrimitiveComponent* ClickedComp, FKey ButtonPressed)
-{
-	if (AMyGameMode* GM = Cast<AMyGameMode>(GetWorld()->GetAuthGameMode()))
-	{
-		GM->HandleUnitSelection(this);
-	}
-}
-
 void AUnit::DestroyUnit()
 {
 	if (AGridManager* GridManager = GetGridManager())
 	{
-		if (AGridCell* Cell = GridManager->GetCellAtPosition(GridPosition))
-		{
-			if (Cell->GetUnit() == this)
-			{
-				Cell->SetUnit(nullptr);
-			}
-		}
+		GridManager->UnregisterUnit(this);
 	}
 
 	if (AMyGameMode* GameMode = Cast<AMyGameMode>(GetWorld()->GetAuthGameMode()))
@@ -6,6 +6,7 @@
 #include "TurnManager.h"
 #include "MyGameMode.h"
 #include "GridCell.h"
+#include "MatchRandom.h"
 #include "Kismet/GameplayStatics.h"
 
 AUnitActions::AUnitActions()
@@ -23,26 +24,32 @@ bool AUnitActions::MoveUnit(AUnit* Unit, FVector2D TargetPosition)
 	if (!Unit || Unit->bHasMovedThisTurn) return false;
 
 	AGridManager* GridManager = GetGridManager();
-	if (!GridManager) return false;
+	AMyGameMode* GameMode = Cast<AMyGameMode>(GetWorld()->GetAuthGameMode());
+	if (!GridManager || !GameMode) return false;
 
-	TArray<FVector2D> Path = GridManager->AStarPathfind(Unit->GetGridPosition(), TargetPosition, Unit->MovementRange);
-
-	if (Path.Num() == 0 || Path.Last() != TargetPosition)
+	// scarto veloce sulla reachability in cache (anche target non interi)
+	if (!GridManager->IsReachableWithin(Unit->GetGridPosition(), TargetPosition, Unit->MovementRange))
 	{
 		UE_LOG(LogTemp, Warning, TEXT("No valid path to the target!"));
 		return false;
 	}
 
-	Unit->MoveToCell(TargetPosition); // aggiorna tutto
-	Unit->bHasMovedThisTurn = true;
+	FTacticsGameState State;
+	GameMode->BuildSimulationState(State);
+
+	const int32 TargetCell = GridManager->GetCellIndex(FMath::RoundToInt(TargetPosition.X), FMath::RoundToInt(TargetPosition.Y));
+	if (!Rules.ApplyMove(State, State.FindUnitSlot(Unit->UnitId), TargetCell))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Move not allowed for %s"), *Unit->GetName());
+		return false;
+	}
+
+	GameMode->ApplySimulationState(State); // aggiorna tutto
 	Unit->bIsSelected = false;
 
-	if (AMyGameMode* GameMode = Cast<AMyGameMode>(GetWorld()->GetAuthGameMode()))
+	if (ATurnManager* TurnManager = GameMode->TurnManager)
 	{
-		if (ATurnManager* TurnManager = GameMode->TurnManager)
-		{
-			TurnManager->CheckTurnCompletion(GameMode);
-		}
+		TurnManager->CheckTurnCompletion(GameMode);
 	}
 	return true;
 }
@@ -56,11 +63,7 @@ bool AUnitActions::IsValidMove(AUnit* Unit, FVector2D TargetPosition)
 		FMath::Abs(TargetPosition.Y - Unit->GetGridPosition().Y);
 	if (Distance > Unit->MovementRange) return false;
 
-	if (AGridCell* TargetCell = GridManager->GetCellAtPosition(TargetPosition))
-	{
-		return !TargetCell->IsOccupied() && !TargetCell->IsObstacle();
-	}
-	return false;
+	return GridManager->IsCellFree(TargetPosition);
 }
 
 AGridManager* AUnitActions::GetGridManager() const
@@ -84,6 +87,10 @@ bool AUnitActions::AttackUnit(AUnit* Attacker, AUnit* Target)
 		return false;
 	}
 
+	AMyGameMode* GameMode = Cast<AMyGameMode>(GetWorld()->GetAuthGameMode());
+	FTacticsGameState State;
+	if (!GameMode || !GameMode->BuildSimulationState(State)) return false;
+
 	FVector2D AttPos = Attacker->GetGridPosition();
 	FVector2D TargetPos = Target->GetGridPosition();
 
@@ -91,59 +98,27 @@ bool AUnitActions::AttackUnit(AUnit* Attacker, AUnit* Target)
 	UE_LOG(LogTemp, Warning, TEXT("Attacker at (%.0f, %.0f), Target at (%.0f, %.0f), Range: %d, Distance: %d"),
 		AttPos.X, AttPos.Y, TargetPos.X, TargetPos.Y, Attacker->AttackRange, Distance);
 
-	if (Distance > Attacker->AttackRange)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("Attack failed - Out of range"));
-		return false;
-	}
+	// range, squadra e corpo a corpo solo adiacente: tutto nelle regole
+	const int32 AttackerSlot = State.FindUnitSlot(Attacker->UnitId);
+	const int32 TargetSlot = State.FindUnitSlot(Target->UnitId);
 
-	if (!Attacker->IsA(ASniper::StaticClass()))
+	FSimAttackResult Result;
+	if (!Rules.ApplyAttack(State, AttackerSlot, TargetSlot,
+		GetMatchRandomStream(this, EMatchRandomStream::Combat),
+		GetMatchRandomStream(this, EMatchRandomStream::Counterattack), Result))
 	{
-		if (AMyGameMode* GM = Cast<AMyGameMode>(Attacker->GetWorld()->GetAuthGameMode()))
-		{
-			if (AGridManager* GridManager = GM->GridManager)
-			{
-				AGridCell* FromCell = GridManager->GetCellAtPosition(AttPos);
-				AGridCell* ToCell = GridManager->GetCellAtPosition(TargetPos);
-				if (FromCell && ToCell)
-				{
-					bool bBlocked = GridManager->IsPathBlocked(FromCell, ToCell);
-					if (bBlocked)
-					{
-						UE_LOG(LogTemp, Warning, TEXT("Attack failed - Obstacle in path"));
-						return false;
-					}
-				}
-			}
-		}
+		UE_LOG(LogTemp, Warning, TEXT("Attack failed - Target not attackable"));
+		return false;
 	}
 
-	int32 Damage = FMath::RandRange(Attacker->MinDamage, Attacker->MaxDamage);
-	Target->Health -= Damage;
+	UE_LOG(LogTemp, Warning, TEXT("%s ha attaccato %s causando %d danni"), *Attacker->GetName(), *Target->GetName(), Result.Damage);
 
-	UE_LOG(LogTemp, Warning, TEXT("%s ha attaccato %s causando %d danni"), *Attacker->GetName(), *Target->GetName(), Damage);
-
-	if (Target->Health <= 0)
+	if (Result.bCounterattack)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("%s è stato distrutto!"), *Target->GetName());
-		Target->DestroyUnit();
-	}
-
-	// contrattacco
-	if (Distance == 1 && Target->CanAttack())
-	{
-		int32 CounterDamage = FMath::RandRange(1, 3);
-		Attacker->Health -= CounterDamage;
-
-		UE_LOG(LogTemp, Warning, TEXT("%s ha ricevuto un contrattacco da %s con %d danni"), *Attacker->GetName(), *Target->GetName(), CounterDamage);
-
-		if (Attacker->Health <= 0)
-		{
-			Attacker->DestroyUnit();
-			UE_LOG(LogTemp, Warning, TEXT("%s è stato distrutto dal contrattacco!"), *Attacker->GetName());
-		}
+		UE_LOG(LogTemp, Warning, TEXT("%s ha ricevuto un contrattacco da %s con %d danni"), *Attacker->GetName(), *Target->GetName(), Result.CounterDamage);
 	}
 
-	Attacker->bHasAttackedThisTurn = true;
+	// distrugge le unità morte (bersaglio e/o attaccante)
+	GameMode->ApplySimulationState(State);
 	return true;
 }
@@ -20,5 +20,44 @@ enum class EUnitActionState : uint8
 	Attacking   UMETA(DisplayName="Attacco")
 };
 
+UENUM(BlueprintType)
+enum class EObstacleConnectivityCheck : uint8
+{
+	Incremental UMETA(DisplayName="Incrementale (test locale + BFS con uscita anticipata)"),
+	Exhaustive  UMETA(DisplayName="Esaustivo (BFS su tutta la griglia per ogni ostacolo)"),
+	CrossCheck  UMETA(DisplayName="Entrambi, segnala le differenze")
+};
+
+UENUM(BlueprintType)
+enum class EAIMode : uint8
+{
+	Expectimax  UMETA(DisplayName="Expectimax (alpha-beta, deterministico)"),
+	MonteCarlo  UMETA(DisplayName="Monte Carlo Tree Search (parallelo)")
+};
+
+UENUM(BlueprintType)
+enum class EAIRolloutPolicy : uint8
+{
+	Random      UMETA(DisplayName="Casuale"),
+	Greedy      UMETA(DisplayName="Greedy (miglior piano euristico)")
+};
+
+UENUM(BlueprintType)
+enum class EGridPathBackend : uint8
+{
+	AStar       UMETA(DisplayName="A* (ogni cella)"),
+	JumpPoint   UMETA(DisplayName="Jump Point Search (solo query senza limite)"),
+	Hierarchical UMETA(DisplayName="HPA* a cluster (griglie grandi, percorso quasi ottimo)")
+};
+
+UENUM(BlueprintType)
+enum class EGridHighlightKind : uint8
+{
+	None        UMETA(DisplayName="Nessuno"),
+	Move        UMETA(DisplayName="Range di movimento"),
+	Attack      UMETA(DisplayName="Bersaglio attaccabile"),
+	PathPreview UMETA(DisplayName="Anteprima percorso")
+};
+
 
 // Note: No class - this is a global enumeration
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridBoardState.h"
+
+// Operazioni bit-parallele sulla board, 64 celle per parola.
+// Con l'indice X * SizeY + Y i vicini lungo Y stanno a ±1 bit e quelli lungo X a ±SizeY bit:
+// espansione ai 4 vicini, flood fill e rombi di Manhattan diventano shift e maschere per parola
+// (una 25x25 sta in 10 parole). Scratch e cache dei rombi per istanza: un'istanza per thread.
+class PROJECT_PAA_API FGridBitboard
+{
+public:
+	// niente da fare se la dimensione non cambia; altrimenti svuota la cache dei rombi
+	void Init(int32 InSizeX, int32 InSizeY);
+	bool Matches(const FGridBoardState& Board) const { return SizeX == Board.SizeX && SizeY == Board.SizeY; }
+
+	// Out = In più i vicini ortogonali delle sue celle, solo per le parole [FirstWord, LastWord]
+	void Expand(const FGridBitLayer& In, FGridBitLayer& Out, int32 FirstWord, int32 LastWord) const;
+
+	// Celle raggiunte da Seeds in al più MaxSteps passi (< 0 = senza limite) attraverso Passable.
+	// Le sorgenti contano anche se non percorribili (es. la cella dell'unità che si muove).
+	// Con StopAt si esce appena quella cella è raggiunta. Restituisce i passi fatti.
+	int32 FloodFill(const FGridBitLayer& Seeds, const FGridBitLayer& Passable, int32 MaxSteps, FGridBitLayer& Out,
+		int32 StopAt = INDEX_NONE);
+
+	// Target raggiungibile da Origin in al più MaxSteps passi su celle libere: stessa risposta
+	// di FGridPathfinder::ComputeReachability, senza distanze né predecessori
+	bool IsReachableWithin(const FGridBoardState& Board, int32 OriginIndex, int32 TargetIndex, int32 MaxSteps);
+
+	// celle entro distanza di Manhattan Radius da CenterIndex, calcolate alla prima richiesta
+	// (il riferimento vale fino alla GetDiamond successiva)
+	const FGridBitLayer& GetDiamond(int32 CenterIndex, int32 Radius);
+
+	// celle né ostacolo né occupate
+	static void GetPassable(const FGridBoardState& Board, FGridBitLayer& Out);
+	static void GetTeamUnits(const FGridBoardState& Board, bool bPlayerTeam, FGridBitLayer& Out);
+
+private:
+	// oltre questo numero di rombi in cache si riparte da zero
+	static constexpr int32 MaxCachedDiamonds = 256;
+
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+
+	// celle con Y == 0 e con Y == SizeY - 1: lo shift di un bit non deve passare da una riga all'altra
+	FGridBitLayer FirstYCells;
+	FGridBitLayer LastYCells;
+
+	FGridBitLayer ExpandScratch;
+	FGridBitLayer PassableScratch;
+	FGridBitLayer SeedScratch;
+	FGridBitLayer ReachedScratch;
+
+	// chiave: (Radius << 32) | CenterIndex
+	TMap<uint64, FGridBitLayer> Diamonds;
+};
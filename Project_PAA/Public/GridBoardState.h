@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Un bit per cella, stesso indice denso di AGridManager::GridCells (X * SizeY + Y)
+struct PROJECT_PAA_API FGridBitLayer
+{
+	TArray<uint64> Words;
+	int32 NumBits = 0;
+
+	void Init(int32 InNumBits);
+	void Reset();
+
+	FORCEINLINE bool Get(int32 Index) const
+	{
+		return (Words[Index >> 6] >> (Index & 63)) & 1ull;
+	}
+
+	FORCEINLINE void Set(int32 Index, bool bValue)
+	{
+		const uint64 Mask = 1ull << (Index & 63);
+		uint64& Word = Words[Index >> 6];
+		Word = bValue ? (Word | Mask) : (Word & ~Mask);
+	}
+
+	int32 CountSetBits() const;
+	bool IsEmpty() const;
+
+	// bit [Start, Start + Count)
+	void SetRange(int32 Start, int32 Count);
+
+	// Operazioni per parola intera tra strati della stessa dimensione: cicli semplici su array
+	// contigui, che il compilatore vettorizza dove il target lo permette
+	void CopyFrom(const FGridBitLayer& Other);
+	void AndWith(const FGridBitLayer& Other);
+	void OrWith(const FGridBitLayer& Other);
+	void AndNotWith(const FGridBitLayer& Other);
+	// complemento di Other, senza i bit oltre NumBits
+	void SetToComplement(const FGridBitLayer& Other);
+
+	// indici dei bit a 1 in ordine crescente, una CountTrailingZeros per bit
+	template<typename FunctorType>
+	void ForEachSetBit(FunctorType&& Visitor) const
+	{
+		for (int32 Word = 0; Word < Words.Num(); Word++)
+		{
+			for (uint64 Bits = Words[Word]; Bits != 0; Bits &= Bits - 1)
+			{
+				Visitor((Word << 6) + static_cast<int32>(FMath::CountTrailingZeros64(Bits)));
+			}
+		}
+	}
+};
+
+// Stato autoritativo della board: solo dati, nessun UObject, copiabile per ricerca/worker thread
+struct PROJECT_PAA_API FGridBoardState
+{
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+
+	FGridBitLayer Obstacles;
+	FGridBitLayer Occupied;
+	FGridBitLayer PlayerOwned; // significativo solo dove Occupied è 1
+
+	// id unità per cella, INDEX_NONE se vuota
+	TArray<int32> UnitIds;
+
+	// incrementato ad ogni modifica, per invalidare cache derivate
+	uint32 Revision = 0;
+
+	void Init(int32 InSizeX, int32 InSizeY);
+
+	FORCEINLINE int32 NumCells() const { return SizeX * SizeY; }
+	FORCEINLINE bool IsValid(int32 X, int32 Y) const { return X >= 0 && X < SizeX && Y >= 0 && Y < SizeY; }
+	FORCEINLINE int32 ToIndex(int32 X, int32 Y) const { return X * SizeY + Y; }
+
+	// distanza Manhattan tra due indici cella
+	FORCEINLINE int32 GetDistance(int32 A, int32 B) const
+	{
+		return FMath::Abs(A / SizeY - B / SizeY) + FMath::Abs(A % SizeY - B % SizeY);
+	}
+
+	FORCEINLINE bool IsObstacle(int32 Index) const { return Obstacles.Get(Index); }
+	FORCEINLINE bool IsOccupied(int32 Index) const { return Occupied.Get(Index); }
+
+	// ostacolo o unità: entrambi bloccano il movimento
+	FORCEINLINE bool IsBlocked(int32 Index) const
+	{
+		const int32 Word = Index >> 6;
+		const uint64 Mask = 1ull << (Index & 63);
+		return ((Obstacles.Words[Word] | Occupied.Words[Word]) & Mask) != 0;
+	}
+
+	FORCEINLINE int32 GetUnitId(int32 Index) const { return UnitIds[Index]; }
+
+	FORCEINLINE bool HasEnemyAt(int32 Index, bool bIsPlayer) const
+	{
+		return Occupied.Get(Index) && PlayerOwned.Get(Index) != bIsPlayer;
+	}
+
+	void SetObstacle(int32 Index, bool bObstacle);
+	void SetUnit(int32 Index, int32 UnitId, bool bIsPlayer);
+	void ClearUnit(int32 Index);
+};
+
+// Celle modificate (ostacolo o unità) con la Revision raggiunta dalla board dopo la modifica.
+// Lo tiene chi possiede la board, non la board stessa: le copie per ricerca/worker restano leggere.
+// Serve a riparare campi di distanza e raggiungibilità invece di ricalcolarli; storia limitata.
+struct PROJECT_PAA_API FGridChangeLog
+{
+	static constexpr int32 MaxEntries = 256;
+
+	// nessuna storia prima della Revision attuale (board nuova o ridimensionata)
+	void Reset(const FGridBoardState& Board);
+
+	// da chiamare dopo ogni modifica della cella
+	void Record(const FGridBoardState& Board, int32 Index);
+
+	// celle cambiate dopo Revision (possono ripetersi); false se la storia non arriva così indietro
+	bool GetChangesSince(uint32 Revision, TArray<int32>& OutCells) const;
+
+private:
+	uint32 BaseRevision = 0;
+	TArray<uint32> Revisions;
+	TArray<int32> Cells;
+};
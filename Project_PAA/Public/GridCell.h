@@ -8,6 +8,7 @@
 // Forward declarations
 class AGridManager;
 class AUnit;
+class UMaterialInstanceDynamic;
 class AMyGameMode;
 
 UCLASS()
@@ -42,14 +43,13 @@ public:
 	int32 GridPositionX;
 	int32 GridPositionY;
 
-	// click cella
-	UFUNCTION()
-	void OnCellClicked(UPrimitiveComponent* ClickedComponent, FKey ButtonPressed);
-
 	// highlight
 	UFUNCTION(BlueprintCallable)
 	void SetHighlight(bool bHighlight);
 
+	// highlight con un materiale dato (es. quello d'attacco del GridManager)
+	void SetHighlightMaterial(UMaterialInterface* Material);
+
 	UFUNCTION(BlueprintCallable)
 	void SetHighlightColor(FLinearColor NewColor);
 
@@ -77,6 +77,22 @@ public:
 	UFUNCTION(BlueprintCallable)
 	FString GetCellName() const { return CellName; }
 
+	// Con il materiale condiviso highlight e ostacolo sono custom primitive data letti dal materiale:
+	// nessun cambio di materiale né MID, solo una scrittura di dati per aggiornamento
+	static constexpr int32 CustomDataHighlight = 0; // RGB = colore, A = acceso (0/1)
+	static constexpr int32 CustomDataObstacle = 4;  // 1 = ostacolo
+	static constexpr int32 CustomDataShade = 5;     // tinta dell'ostacolo
+
+	// scala della mesh piana: lastra bassa o blocco d'ostacolo (anche per le celle istanziate)
+	static FVector GetCellScale(bool bObstacle) { return bObstacle ? FVector(1.2f, 1.2f, 2.0f) : FVector(1.0f, 1.0f, 0.1f); }
+
+	// false quando gli ostacoli li disegna il GridManager: SetObstacle aggiorna solo il flag
+	void SetDrawsObstacle(bool bDraws) { bDrawsObstacle = bDraws; }
+
+	// subito dopo lo spawn, prima di SetObstacle; senza chiamarla si usano i materiali separati
+	void UseSharedMaterial(UMaterialInterface* SharedMaterial, FLinearColor InDefaultHighlightColor);
+	bool UsesSharedMaterial() const { return bUsesSharedMaterial; }
+
 
 private:
 	// materiali
@@ -88,4 +104,15 @@ private:
 
 	UPROPERTY(EditDefaultsOnly, Category = "Grid")
 	UMaterialInterface* HighlightMoveMaterial;
+
+	bool bUsesSharedMaterial = false;
+	bool bDrawsObstacle = true;
+	FLinearColor DefaultHighlightColor = FLinearColor::Yellow;
+
+	// solo senza materiale condiviso: un MID per uso, creato la prima volta e poi riusato
+	UPROPERTY(Transient)
+	UMaterialInstanceDynamic* ObstacleMID = nullptr;
+
+	UPROPERTY(Transient)
+	UMaterialInstanceDynamic* HighlightMID = nullptr;
 };
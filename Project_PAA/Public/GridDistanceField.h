@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridBoardState.h"
+
+// Distanza a piedi di ogni cella dalla sorgente più vicina, con l'etichetta di quella sorgente.
+// Una sola BFS multi-sorgente serve tutte le unità al posto di una ricerca per unità.
+struct PROJECT_PAA_API FGridDistanceField
+{
+	uint32 BoardRevision = 0;
+	bool bBuilt = false;
+	bool bExpandBlockedSources = false;
+
+	// per cella: INDEX_NONE se nessuna sorgente è raggiungibile
+	TArray<int32> Distance;
+	TArray<int32> Label;
+
+	// sorgenti e poi celle in ordine BFS, fa anche da coda.
+	// Dopo una Repair è solo l'elenco (con ripetizioni) delle celle scritte.
+	TArray<int32> Queue;
+
+	// sorgenti attuali nell'ordine di AddSource
+	TArray<int32> Sources;
+
+	FORCEINLINE int32 GetDistance(int32 Index) const { return Distance.IsValidIndex(Index) ? Distance[Index] : INDEX_NONE; }
+	FORCEINLINE int32 GetLabel(int32 Index) const { return Label.IsValidIndex(Index) ? Label[Index] : INDEX_NONE; }
+
+	void Begin(const FGridBoardState& Board);
+
+	// distanza 0; la prima sorgente aggiunta su una cella vince
+	void AddSource(int32 Index, int32 InLabel);
+
+	// BFS sulle celle libere. bExpandBlockedSources: le sorgenti bloccate (es. unità nemiche)
+	// propagano ai vicini; altrimenti valgono 0 solo su se stesse
+	void Propagate(const FGridBoardState& Board, bool bInExpandBlockedSources);
+
+	// per una cella bloccata fuori dal campo (es. quella occupata da chi chiede): 1 + miglior vicino
+	int32 GetDistanceFromBlocked(const FGridBoardState& Board, int32 Index, int32* OutLabel = nullptr) const;
+
+	// Aggiornamento incrementale dopo modifiche alla board, al posto di Begin/Propagate:
+	// BeginRepair, AddSource con tutte le sorgenti attuali (come per una costruzione), poi Repair
+	// con le celle cambiate da BoardRevision. Si ricalcolano solo le celle la cui distanza può essere
+	// cambiata; a parità di distanza l'etichetta può differire da quella di una BFS completa.
+	// Restituisce le celle invalidate più quelle riscritte, cioè il lavoro svolto.
+	void BeginRepair();
+	int32 Repair(const FGridBoardState& Board, const TArray<int32>& ChangedCells);
+
+private:
+	enum ERepairFlags : uint8
+	{
+		NewSource = 1,
+		Seed = 2,
+		Visited = 4,
+		Affected = 8
+	};
+
+	bool bRepairing = false;
+	TArray<FIntPoint> PendingSources; // X = cella, Y = etichetta
+	TArray<uint8> RepairFlags;
+	TArray<int32> RepairTouched;
+	TArray<int32> RepairAffected;
+	TArray<uint64> RepairHeap; // (distanza << 32) | cella
+
+	FORCEINLINE bool IsExpandable(const FGridBoardState& Board, int32 Index) const
+	{
+		return !Board.IsBlocked(Index) || (bExpandBlockedSources && Distance[Index] == 0);
+	}
+
+	void FlagCell(int32 Index, uint8 Flag);
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlobalEnums.h"
+
+// Celle evidenziate e loro tipo, separate da ciò che è già a schermo.
+// Set/ClearAll cambiano solo lo stato voluto; Flush consegna le sole celle il cui tipo
+// è davvero cambiato dall'ultimo Flush (spegni e riaccendi nello stesso frame = niente).
+// Il costo segue le celle toccate e quelle accese, mai la dimensione della board.
+class PROJECT_PAA_API FGridHighlightSet
+{
+public:
+	using FApplyFunction = TFunctionRef<void(int32 CellIndex, EGridHighlightKind Kind)>;
+
+	// board nuova: niente di acceso
+	void Reset(int32 NumCells);
+
+	void Set(int32 CellIndex, EGridHighlightKind Kind);
+	void ClearAll();
+
+	EGridHighlightKind Get(int32 CellIndex) const
+	{
+		return Desired.IsValidIndex(CellIndex) ? static_cast<EGridHighlightKind>(Desired[CellIndex]) : EGridHighlightKind::None;
+	}
+
+	bool HasPendingChanges() const { return Touched.Num() > 0; }
+
+	// chiama Apply per ogni cella cambiata e restituisce quante erano
+	int32 Flush(FApplyFunction Apply);
+
+private:
+	// tipo voluto e tipo a schermo, per cella
+	TArray<uint8> Desired;
+	TArray<uint8> Applied;
+
+	// celle toccate dall'ultimo Flush (senza duplicati) e celle accese a schermo
+	TArray<int32> Touched;
+	TArray<bool> IsTouched;
+	TArray<int32> Lit;
+};
@@ -4,12 +4,23 @@
 #include "GameFramework/Actor.h"
 #include "GlobalEnums.h"
 #include "GridCell.h"
+#include "GridBoardState.h"
+#include "GridPathfinder.h"
+#include "GridPathService.h"
+#include "GridDistanceField.h"
+#include "GridStaticDistances.h"
+#include "GridPathHierarchy.h"
+#include "GridBitboard.h"
+#include "GridUnitIndex.h"
+#include "GridHighlightSet.h"
 #include "GridManager.generated.h"
 
 // Forward declaration
 class AUnit;
 class AMyGameMode;
 class AUnitActions;
+class UInstancedStaticMeshComponent;
+class UHierarchicalInstancedStaticMeshComponent;
 
 UCLASS()
 class PROJECT_PAA_API AGridManager : public AActor
@@ -23,6 +34,11 @@ protected:
     virtual void BeginPlay() override;
 
 public:
+    virtual void Tick(float DeltaSeconds) override;
+
+    // inizio/fine della scelta della destinazione: il tick (anteprima del percorso) gira solo nel mezzo
+    void SetMoveTargeting(bool bActive);
+
     // Grid dimensions and properties
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
     int32 GridSizeX = 25;
@@ -33,7 +49,8 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
     float CellSize = 100.0f;
 
-    // Array to store grid cells
+    // Array to store grid cells, indice denso: GridCells[X * GridSizeY + Y]
+    // (slot nullptr se lo spawn della cella fallisce e sempre con bUseInstancedCells, mai compattato)
     UPROPERTY()
     TArray<AGridCell*> GridCells;
 
@@ -45,10 +62,36 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid", meta = (ClampMin = "0.0", ClampMax = "1.0"), meta = (AllowPrivateAccess = "true"))
     float SpawnProbability = 0.15f;
 
+    // Come verificare che ogni cella libera resti raggiungibile durante la generazione
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
+    EObstacleConnectivityCheck ObstacleConnectivityCheck = EObstacleConnectivityCheck::Incremental;
+
+    // Backend delle query senza limite (FindPath); quelle con MaxRange restano A*
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Pathfinding")
+    EGridPathBackend PathBackend = EGridPathBackend::AStar;
+
+    // lato dei cluster HPA* (backend Hierarchical); cambiarlo ricostruisce la gerarchia
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Pathfinding", meta = (ClampMin = "4"))
+    int32 HierarchyClusterSize = 16;
+
+    // A*, JPS e HPA* su board sintetiche 25/100/500, risultati nel log
+    UFUNCTION(BlueprintCallable, CallInEditor, Category = "Grid|Pathfinding")
+    void RunPathBenchmark();
+
     // Obstacle Blueprint Reference
     UPROPERTY(EditAnywhere, Category = "Grid")
     TSubclassOf<AActor> ObstacleBlueprint;
 
+    // Ostacoli come istanze di una HISM del GridManager al posto di un ObstacleBlueprint per cella:
+    // un batch, nessun attore, e la cella sotto resta una lastra. Mesh con pivot alla base e impronta
+    // di una cella; vuoto = ObstacleBlueprint
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Rendering")
+    UStaticMesh* ObstacleMesh = nullptr;
+
+    // custom data 0 = tinta casuale dell'ostacolo (0.3-1)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Rendering")
+    UMaterialInterface* ObstacleInstanceMaterial = nullptr;
+
 
     // Functions
     void CreateGrid();
@@ -56,11 +99,16 @@ public:
     void DestroyGrid();
     bool IsCellBlocked(int32 X, int32 Y) const;
 
+    // click su una cella: piazzamento o azione secondo la fase di gioco
     UFUNCTION()
-    void HandleCellClick(AGridCell* ClickedCell);
+    void HandleCellClick(int32 Index);
+
+    // cella sotto il cursore: raggio del cursore intersecato col piano della griglia,
+    // nessuna collisione né trace. false fuori dalla griglia
+    bool GetCellUnderCursor(int32& OutIndex) const;
     
     UFUNCTION()
-    void TryMoveSelectedUnit(AGridCell* TargetCell);
+    void TryMoveSelectedUnit(int32 TargetIndex);
     
     void HandlePlayerAction(AGridCell* ClickedCell);
 
@@ -73,24 +121,85 @@ public:
     
     // Utility Functions
     FString GetCellName(int32 X, int32 Y);
-    FVector GetCellWorldPosition(int32 X, int32 Y);
+    FVector GetCellWorldPosition(int32 X, int32 Y) const;
     bool FindRandomEmptyCell(int32& OutX, int32& OutY);
 
+    // nullptr con bUseInstancedCells: lì le celle esistono solo come indice
     AGridCell* GetCellAtPosition(FVector2D Position) const;
     bool IsCellFree(FVector2D CellPosition) const;
 
+    // Accesso diretto per indice denso (bounds check + una lettura)
+    bool IsValidCoord(int32 X, int32 Y) const { return X >= 0 && X < GridSizeX && Y >= 0 && Y < GridSizeY; }
+    int32 GetCellIndex(int32 X, int32 Y) const { return X * GridSizeY + Y; }
+    FIntPoint GetCellCoord(int32 Index) const { return FIntPoint(Index / GridSizeY, Index % GridSizeY); }
+    int32 GetNumCells() const { return GridSizeX * GridSizeY; }
+    AGridCell* GetCellAt(int32 X, int32 Y) const;
+
+    // Iterazione in blocco senza arrotondamenti FVector2D per cella
+    void ForEachCellInRect(int32 MinX, int32 MinY, int32 MaxX, int32 MaxY, TFunctionRef<void(int32 X, int32 Y, int32 Index)> Visitor) const;
+    void ForEachCellInDiamond(int32 CenterX, int32 CenterY, int32 Radius, TFunctionRef<void(int32 X, int32 Y, int32 Index)> Visitor) const;
+    void ForEachNeighbour(int32 X, int32 Y, TFunctionRef<void(int32 X, int32 Y, int32 Index)> Visitor) const;
+
     // Functions to get grid and cell dimensions
     int32 GetGridSizeX() const { return GridSizeX; }
     int32 GetGridSizeY() const { return GridSizeY; }
     float GetCellSize() const { return CellSize; }
     
-void CreateObstacleMap(TArray<TArray<bool>>& OutObstacleMap) const;
-    bool AreAllCellsReachable(const TArray<TArray<bool>>& InObstacleMap) const;
-    void BFS(const TArray<TArray<bool>>& InObstacleMap, TArray<TArray<bool>>& Visited, int32 StartX, int32 StartY) const;
+    void CreateObstacleMap(FGridBitLayer& OutObstacleMap) const;
+    bool AreAllCellsReachable(const FGridBitLayer& InObstacleMap) const;
+    void BFS(const FGridBitLayer& InObstacleMap, FGridBitLayer& Visited, int32 StartX, int32 StartY) const;
+
+    // Assumendo la mappa attuale connessa: bloccare (X,Y) la lascia connessa?
+    bool CanAddObstacleKeepingConnectivity(const FGridBitLayer& InObstacleMap, int32 X, int32 Y, int32 FreeCellCount,
+        TArray<uint32>& VisitStamp, uint32& Stamp, TArray<int32>& Queue) const;
+
+    // Stato board autoritativo; le AGridCell sono solo la vista sincronizzata da qui
+    const FGridBoardState& GetBoardState() const { return Board; }
+    void SetCellObstacle(int32 X, int32 Y, bool bObstacle);
+    void SetCellUnit(int32 X, int32 Y, AUnit* Unit);
+    void SyncCellView(int32 Index);
+
+    // id stabile assegnato alla prima entrata in griglia
+    int32 RegisterUnit(AUnit* Unit);
+    void UnregisterUnit(AUnit* Unit);
+
+    // Registro cella -> unità e unità -> cella, letture dirette senza overlap
+    AUnit* GetUnitAt(int32 X, int32 Y) const;
+    AUnit* GetUnitAtIndex(int32 Index) const;
+    int32 GetUnitCellIndex(const AUnit* Unit) const;
+    AUnit* GetRegisteredUnit(int32 UnitId) const;
 
    
     TArray<FVector2D> FindPath(FVector2D Start, FVector2D End , AUnit* MovingUnit);
     TArray<FVector2D> AStarPathfind(FVector2D Start, FVector2D End, int32 MaxRange) const;
+
+    // Raggiungibilità da Origin entro Range (una BFS, in cache finché la board non cambia)
+    const FGridReachability& GetReachability(FVector2D Origin, int32 Range) const;
+    bool IsReachableWithin(FVector2D Origin, FVector2D Target, int32 Range) const;
+
+    // Come GetReachability/FindPath, ma calcolate su un worker contro uno snapshot della board.
+    // OnReady arriva sul game thread e sempre riferito alla board corrente: subito se il risultato
+    // è già in cache, altrimenti a calcolo finito (rilanciato se nel frattempo la board è cambiata).
+    void RequestReachability(FVector2D Origin, int32 Range, TFunction<void(const FGridReachability&)> OnReady);
+    void RequestPath(FVector2D Start, FVector2D End, int32 MaxCost, TFunction<void(const TArray<FVector2D>&)> OnReady);
+
+    // copia immutabile della board, condivisa da tutte le richieste finché Revision non cambia
+    FGridBoardSnapshot GetBoardSnapshot() const;
+
+    // Distanze a piedi tra tutte le coppie di celle, solo ostacoli: costruite dopo GenerateObstacles,
+    // aggiornate in modo incrementale da SetCellObstacle. Vuote se la griglia supera MaxCells.
+    const FGridStaticDistances& GetStaticDistances() const { return StaticDistances; }
+    void BuildStaticDistances();
+
+    // copia della tabella da passare ad altri thread, condivisa finché gli ostacoli non cambiano:
+    // chi la tiene la tiene viva anche dopo la distruzione del GridManager. nullptr se la tabella manca
+    FGridStaticDistancesSnapshot GetStaticDistancesSnapshot() const;
+
+    // Campo di distanza per l'IA, riparato solo dove la board cambia (etichetta = UnitId).
+    // Distanza a piedi dalla cella più vicina da cui un attaccante con questo raggio colpisce la squadra
+    // (l'IA ci ordina le destinazioni, vedi FTacticsApproachField). Il riferimento resta valido anche
+    // chiedendo altri campi, ma il contenuto cambia alla chiamata successiva dopo una modifica della board:
+    const FGridDistanceField& GetAttackDistanceField(bool bTargetPlayerTeam, int32 AttackRange, bool bRanged) const;
     
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
     UMaterialInterface* DefaultTileMaterial;
@@ -101,6 +210,43 @@ void CreateObstacleMap(TArray<TArray<bool>>& OutObstacleMap) const;
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
     UMaterialInterface* HighlightAttackMaterial;
 
+    // anteprima del percorso; se vuoto si usa quello del movimento
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
+    UMaterialInterface* HighlightPathMaterial = nullptr;
+
+    // Materiale unico per tutte le celle: highlight e ostacoli via custom primitive data
+    // (vedi AGridCell::CustomDataHighlight). Vuoto = materiali separati per stato
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Rendering")
+    UMaterialInterface* SharedCellMaterial = nullptr;
+
+    // Celle solo dati: niente attori AGridCell, un'istanza per cella (istanza = indice cella) di una
+    // sola UInstancedStaticMeshComponent, con highlight e ostacolo nei custom data per istanza
+    // (stessa disposizione di AGridCell::CustomData*, serve SharedCellMaterial). Per board da 100x100 in su
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Rendering")
+    bool bUseInstancedCells = false;
+
+    bool UsesInstancedCells() const { return CellInstances != nullptr; }
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Rendering")
+    FLinearColor HighlightMoveColor = FLinearColor(1.0f, 0.8f, 0.2f);
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Rendering")
+    FLinearColor HighlightAttackColor = FLinearColor(0.9f, 0.1f, 0.1f);
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Rendering")
+    FLinearColor HighlightPathColor = FLinearColor(0.2f, 0.7f, 1.0f);
+
+    // Durante la scelta della destinazione: percorso fino alla cella sotto il cursore, preso dai
+    // predecessori della raggiungibilità in cache della selezione (nessuna ricerca per hover).
+    // Al più un aggiornamento per frame, solo quando cambia la cella; la latenza hover -> highlight
+    // scritto finisce nel log a fine selezione
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Rendering")
+    bool bShowHoverPathPreview = true;
+
+    // tipo di highlight voluto per la cella (a schermo dal prossimo tick)
+    void SetCellHighlight(int32 Index, EGridHighlightKind Kind);
+    EGridHighlightKind GetCellHighlight(int32 Index) const { return Highlights.Get(Index); }
+
     /*bool bIsMovementRangeVisible;
     bool bIsHighlightActive;
     AUnit* LastHighlightedUnit;*/
@@ -109,7 +255,7 @@ void CreateObstacleMap(TArray<TArray<bool>>& OutObstacleMap) const;
     UPROPERTY()
     AUnit* CurrentlyHighlightedUnit = nullptr;
     void HighlightMovementRange(FVector2D Center, int32 Range, bool bHighlight);
-    void TryAttackSelectedUnit(AGridCell* TargetCell);
+    void TryAttackSelectedUnit(int32 TargetIndex);
     // In GridManager.h
     UFUNCTION(BlueprintCallable, Category = "Grid")
     void HighlightAttackRange(FVector2D Center, int32 Range, bool bHighlight, bool bIsRangedAttack, AUnit* Attacker);
@@ -127,6 +273,115 @@ void CreateObstacleMap(TArray<TArray<bool>>& OutObstacleMap) const;
 private:
     // Flag to track if the grid has been created
     bool bGridCreated;
+
+    FGridBoardState Board;
+
+    FGridStaticDistances StaticDistances;
+
+    // motore A* condiviso da AStarPathfind/FindPath, scratch riusato tra le query
+    mutable FGridPathfinder Pathfinder;
+    mutable TArray<int32> PathScratch;
+
+    // cluster e ingressi HPA*, invalidati cella per cella da ogni modifica della board
+    mutable FGridPathHierarchy PathHierarchy;
+
+    // flood fill e rombi di range a parole di 64 bit; strati di appoggio riusati tra le chiamate
+    mutable FGridBitboard Bitboard;
+    mutable FGridBitLayer BitScratchA;
+    mutable FGridBitLayer BitScratchB;
+
+    // celle cambiate per Revision: campi di distanza e raggiungibilità si riparano invece di ricalcolarsi
+    FGridChangeLog BoardChanges;
+    mutable TArray<int32> ChangedCellsScratch;
+
+    // dopo ogni modifica di Board
+    void NotifyCellChanged(int32 Index);
+    TArray<FVector2D> RunPathQuery(FVector2D Start, FVector2D End, int32 MaxCost) const;
+
+    // due slot: selezione chiede insieme range movimento e range attacco
+    mutable FGridReachability ReachabilityCache[2];
+    mutable int32 NextReachabilitySlot = 0;
+    const FGridReachability* FindCachedReachability(int32 OriginIndex, int32 Range) const;
+    // slot vecchio con stessa origine e range: aggiornato con le celle cambiate nel frattempo
+    const FGridReachability* RepairCachedReachability(int32 OriginIndex, int32 Range) const;
+    FGridReachability& AllocReachabilitySlot() const;
+
+    FGridPathService PathService;
+    mutable TSharedPtr<const FGridBoardState, ESPMode::ThreadSafe> BoardSnapshot;
+    mutable FGridStaticDistancesSnapshot StaticDistancesSnapshot;
+
+    // avanza a ogni ClearHighlights: i risultati asincroni di una selezione superata vengono scartati
+    uint32 HighlightSerial = 0;
+
+    // highlight voluti e a schermo: i materiali si cambiano una volta per frame, solo sulle celle cambiate
+    FGridHighlightSet Highlights;
+    bool bHighlightFlushPending = false;
+    void RequestHighlightFlush();
+    void FlushHighlights();
+
+    // anteprima del percorso: cella sotto il cursore e celle accese come PathPreview
+    int32 HoverCellIndex = INDEX_NONE;
+    TArray<int32> HoverPath;
+    TArray<int32> HoverPathScratch;
+    void UpdateHoverPreview();
+    void ClearHoverPreview();
+
+    // latenza degli aggiornamenti dell'anteprima dall'ultimo log
+    double HoverLatencySumMs = 0.0;
+    double HoverLatencyMaxMs = 0.0;
+    int32 HoverLatencySamples = 0;
+
+    // solo con bUseInstancedCells, creata da CreateGrid
+    UPROPERTY(Transient)
+    UInstancedStaticMeshComponent* CellInstances = nullptr;
+
+    // ostacoli già scritti su trasformazioni e custom data delle istanze
+    FGridBitLayer InstancedObstacles;
+
+    void CreateCellInstances();
+
+    // solo con ObstacleMesh: un'istanza per cella ostacolo, indici densi
+    UPROPERTY(Transient)
+    UHierarchicalInstancedStaticMeshComponent* ObstacleInstances = nullptr;
+
+    // cella -> istanza (INDEX_NONE se non è ostacolo) e istanza -> cella: togliendo un ostacolo
+    // l'ultima istanza prende il suo posto, così basta rimuovere sempre l'ultima
+    TArray<int32> ObstacleInstanceOfCell;
+    TArray<int32> ObstacleInstanceCells;
+    TArray<float> ObstacleInstanceShades;
+
+    void CreateObstacleInstances();
+    void AddObstacleInstance(int32 Index);
+    void RemoveObstacleInstance(int32 Index);
+
+    // componenti creati a runtime: radice dell'attore o figli della radice
+    void AttachGridComponent(USceneComponent* Component);
+
+    // unico punto d'ingresso dei click sulla griglia (celle, unità, istanze)
+    void OnLeftMouseClick();
+
+    struct FAttackFieldCacheEntry
+    {
+        bool bTargetPlayerTeam = false;
+        int32 AttackRange = 0;
+        bool bRanged = false;
+        FGridDistanceField Field;
+    };
+
+    // una voce per allocazione: aggiungerne non sposta i campi già restituiti
+    mutable TArray<TUniquePtr<FAttackFieldCacheEntry>> AttackDistanceFields;
+
+    // indice = AUnit::UnitId
+    UPROPERTY()
+    TArray<AUnit*> RegisteredUnits;
+
+    // indice = AUnit::UnitId, valore = indice cella (INDEX_NONE se fuori griglia)
+    TArray<int32> UnitCellIndices;
+
+    // stesse posizioni di UnitCellIndices, divise per squadra e per zona
+    FGridUnitIndex UnitIndex;
+    TArray<int32> UnitIdScratch;
+
     int32 HeuristicCost(FVector2D A, FVector2D B) const;
 
 };
\ No newline at end of file
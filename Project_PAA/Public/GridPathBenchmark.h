@@ -0,0 +1,45 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct PROJECT_PAA_API FGridPathBenchmarkResult
+{
+	int32 Size = 0;
+	float ObstacleProbability = 0.f;
+
+	int32 NumQueries = 0;
+	int32 NumFound = 0;
+	int32 NumMismatches = 0; // esito o lunghezza diversi tra A* e JPS: deve restare 0
+
+	double AStarMs = 0.0;
+	double JumpPointMs = 0.0;
+	int64 AStarExpanded = 0;
+	int64 JumpPointExpanded = 0;
+
+	// HPA*: quasi ottimo, quindi si misurano i passi in più rispetto ad A*
+	double HierarchicalBuildMs = 0.0;
+	double HierarchicalMs = 0.0;
+	int64 HierarchicalExpanded = 0;
+	int64 HierarchicalExtraSteps = 0;
+	int32 NumHierarchicalMismatches = 0; // esito diverso da A*: deve restare 0
+
+	// FGridUnitIndex sulle unità della board, una query per coppia: secchi contro scansione degli id
+	int32 NumUnits = 0;
+	int32 NumUnitIndexMismatches = 0; // deve restare 0
+};
+
+// Confronto A* / Jump Point Search / HPA* su query senza limite, su board quadrate sintetiche:
+// ostacoli indipendenti con la probabilità data (senza garanzia di connessione, come
+// SpawnProbability ma senza il controllo di AGridManager), unità sparse sulle celle restanti
+// e coppie casuali di celle libere. Sulle stesse unità controlla anche FGridUnitIndex: con
+// poche unità il gioco non passa mai dai secchi, qui le squadre ne hanno centinaia.
+struct PROJECT_PAA_API FGridPathBenchmark
+{
+	// frazione di celle occupate da unità, in aggiunta agli ostacoli
+	static constexpr float UnitProbability = 0.05f;
+
+	static FGridPathBenchmarkResult Run(int32 Size, float ObstacleProbability, int32 NumQueries, uint64 Seed);
+
+	// 25x25, 100x100 e 500x500 con più probabilità di ostacolo; una riga di log per configurazione
+	static void RunDefaultSuite(uint64 Seed, TArray<FGridPathBenchmarkResult>& OutResults);
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridBoardState.h"
+
+class FGridPathfinder;
+
+// Pathfinding gerarchico (HPA*) per griglie grandi.
+// La griglia è divisa in cluster ClusterSize x ClusterSize; sui bordi tra cluster ogni tratto
+// libero da entrambi i lati dà uno o due ingressi (coppie di celle adiacenti). Dentro ogni
+// cluster si tengono le distanze esatte tra i suoi ingressi. Una query lunga cerca sul grafo
+// degli ingressi e poi raffina ogni tratto con una BFS limitata al cluster: il costo cresce con
+// la distanza in cluster, non in celle. Il percorso è quasi ottimo (non sempre il più corto).
+// Ostacoli e occupazione contano entrambi: ogni cella cambiata va segnalata con MarkCellChanged,
+// e alla query successiva si ricostruiscono solo i cluster e i bordi toccati.
+// Non thread-safe: un'istanza per board.
+class PROJECT_PAA_API FGridPathHierarchy
+{
+public:
+	// tratti di bordo fino a questa larghezza hanno un solo ingresso, al centro
+	static constexpr int32 MaxSingleEntranceWidth = 5;
+
+	explicit FGridPathHierarchy(int32 InClusterSize = 16);
+
+	// cambiare dimensione invalida tutto
+	void SetClusterSize(int32 InClusterSize);
+	int32 GetClusterSize() const { return ClusterSize; }
+
+	void MarkCellChanged(int32 Index);
+	void MarkAllDirty();
+
+	// ricostruisce subito cluster e bordi sporchi (FindPath lo fa da sé)
+	void Refresh(const FGridBoardState& Board);
+
+	// Start..Goal senza limite di costo; la cella di partenza non viene controllata.
+	// Start e Goal in cluster vicini, o ricerca astratta fallita: A* piatto con Fallback.
+	bool FindPath(const FGridBoardState& Board, int32 StartIndex, int32 GoalIndex, FGridPathfinder& Fallback, TArray<int32>& OutPath);
+
+	// statistiche dell'ultima query / ricostruzione
+	bool WasLastQueryHierarchical() const { return bLastHierarchical; }
+	int32 GetLastExpandedCount() const { return LastExpanded; }
+	int32 GetLastRebuiltClusters() const { return LastRebuiltClusters; }
+	int32 GetNumNodes() const;
+
+private:
+	// coppie ingresso tra due cluster: X = cella lato cluster inferiore, Y = cella lato superiore
+	struct FBorder
+	{
+		bool bDirty = true;
+		TArray<FIntPoint> Entrances;
+	};
+
+	struct FCluster
+	{
+		bool bDirty = true;
+		TArray<int32> Nodes;
+		// Nodes.Num()^2 distanze dentro il cluster, INDEX_NONE se non collegati
+		TArray<int32> Costs;
+	};
+
+	struct FLink
+	{
+		int32 Cell;
+		int32 Cost;
+	};
+
+	struct FOpenNode
+	{
+		int32 F;
+		int32 G;
+		int32 Index;
+	};
+
+	struct FOpenNodeLess
+	{
+		FORCEINLINE bool operator()(const FOpenNode& A, const FOpenNode& B) const
+		{
+			return A.F < B.F || (A.F == B.F && A.G > B.G);
+		}
+	};
+
+	void Init(const FGridBoardState& Board);
+
+	FORCEINLINE int32 GetClusterOf(int32 Index) const
+	{
+		return ((Index / SizeY) / ClusterSize) * NumClustersY + (Index % SizeY) / ClusterSize;
+	}
+
+	void MarkClusterDirty(int32 ClusterX, int32 ClusterY);
+	void MarkBorderDirty(TArray<FBorder>& Borders, TArray<int32>& DirtyList, int32 BorderIndex);
+
+	// bordi lungo X: tra (CX, CY) e (CX + 1, CY); lungo Y: tra (CX, CY) e (CX, CY + 1)
+	void RebuildBorder(const FGridBoardState& Board, bool bAlongX, int32 BorderIndex);
+	void RebuildCluster(const FGridBoardState& Board, int32 ClusterIndex);
+
+	// BFS dentro un cluster da From (non controllata); si ferma su StopAt se valida
+	void SearchCluster(const FGridBoardState& Board, int32 ClusterIndex, int32 From, int32 StopAt);
+	FORCEINLINE bool IsLocallyReached(int32 Index) const { return LocalStamp[Index] == LocalGeneration; }
+
+	bool SearchAbstract(const FGridBoardState& Board, int32 StartIndex, int32 GoalIndex);
+	bool Refine(const FGridBoardState& Board, int32 StartIndex, int32 GoalIndex, TArray<int32>& OutPath);
+
+	int32 ClusterSize = 16;
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+	int32 NumClustersX = 0;
+	int32 NumClustersY = 0;
+
+	TArray<FCluster> Clusters;
+	TArray<FBorder> BordersX;
+	TArray<FBorder> BordersY;
+	TArray<int32> DirtyClusters;
+	TArray<int32> DirtyBordersX;
+	TArray<int32> DirtyBordersY;
+
+	// per cella: slot nei Nodes del suo cluster, INDEX_NONE se non è un ingresso
+	TArray<int32> NodeSlot;
+
+	// BFS locale, a timbro come FGridPathfinder
+	uint32 LocalGeneration = 0;
+	TArray<uint32> LocalStamp;
+	TArray<int32> LocalDistance;
+	TArray<int32> LocalParent;
+	TArray<int32> LocalQueue;
+
+	// ricerca astratta
+	uint32 Generation = 0;
+	TArray<uint32> SeenStamp;
+	TArray<uint32> ClosedStamp;
+	TArray<int32> GScore;
+	TArray<int32> Parent;
+	TArray<FOpenNode> OpenHeap;
+	TArray<FLink> StartLinks;
+	TArray<FLink> GoalLinks;
+	TArray<int32> AbstractPath;
+
+	bool bLastHierarchical = false;
+	int32 LastExpanded = 0;
+	int32 LastRebuiltClusters = 0;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlobalEnums.h"
+#include "GridBoardState.h"
+#include "GridPathfinder.h"
+
+// Board congelata condivisa con i worker: creata una volta per Revision, mai modificata dopo
+using FGridBoardSnapshot = TSharedRef<const FGridBoardState, ESPMode::ThreadSafe>;
+
+struct PROJECT_PAA_API FGridPathResult
+{
+	uint32 BoardRevision = 0;
+	bool bFound = false;
+	TArray<int32> Path; // Start..Goal come indici cella
+};
+
+// Pathfinding asincrono su snapshot immutabili della board.
+// Le richieste si fanno dal game thread; il calcolo gira sui worker del task graph e i callback
+// tornano sempre sul game thread. Richieste identiche ancora in volo (stesso snapshot, stessi
+// parametri) non lanciano un secondo calcolo: il risultato viene consegnato a tutti.
+// Alla distruzione del servizio i callback pendenti vengono scartati; i worker in corso
+// finiscono da soli e tengono vivo solo ciò che usano.
+class PROJECT_PAA_API FGridPathService
+{
+public:
+	using FPathCallback = TFunction<void(const FGridPathResult&)>;
+	using FReachabilityCallback = TFunction<void(const FGridReachability&)>;
+
+	FGridPathService();
+	~FGridPathService();
+
+	// Hierarchical non ha senso su snapshot usa-e-getta: sui worker vale come AStar
+	void SetBackend(EGridPathBackend InBackend) { Backend = InBackend; }
+
+	void RequestPath(const FGridBoardSnapshot& Board, int32 StartIndex, int32 GoalIndex, int32 MaxCost, FPathCallback OnComplete);
+	void RequestReachability(const FGridBoardSnapshot& Board, int32 OriginIndex, int32 MaxCost, FReachabilityCallback OnComplete);
+
+	// calcoli distinti in volo / richieste accodate a uno già in volo (dall'avvio)
+	int32 GetNumInFlight() const;
+	int32 GetNumCoalesced() const;
+
+private:
+	struct FState;
+
+	EGridPathBackend Backend = EGridPathBackend::AStar;
+	TSharedRef<FState, ESPMode::ThreadSafe> State;
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridBoardState.h"
+#include "GlobalEnums.h"
+
+class FGridStaticDistances;
+
+// Celle raggiungibili da un'origine entro MaxCost passi, con distanze e predecessori.
+// Reset e ricalcolo toccano solo le celle raggiunte, non tutta la griglia.
+struct PROJECT_PAA_API FGridReachability
+{
+	int32 OriginIndex = INDEX_NONE;
+	int32 MaxCost = 0;
+	uint32 BoardRevision = 0;
+
+	// per cella: INDEX_NONE se non raggiunta
+	TArray<int32> Distance;
+	TArray<int32> Parent;
+
+	// ordine BFS, origine inclusa
+	TArray<int32> ReachedCells;
+
+	bool IsValid() const { return OriginIndex != INDEX_NONE; }
+	bool IsReachable(int32 Index) const { return Distance.IsValidIndex(Index) && Distance[Index] != INDEX_NONE; }
+	int32 GetDistance(int32 Index) const { return Distance.IsValidIndex(Index) ? Distance[Index] : INDEX_NONE; }
+
+	// Origin..Goal risalendo i predecessori, vuoto se non raggiunta
+	void BuildPath(int32 GoalIndex, TArray<int32>& OutPath) const;
+
+	void Reset(int32 NumCells);
+};
+
+// Motore A* condiviso su griglia 4-connessa a costo unitario.
+// Gli array per-cella sono riusati tra una query e l'altra (timbro di generazione),
+// quindi a regime non alloca nulla. Non thread-safe: un'istanza per thread.
+class PROJECT_PAA_API FGridPathfinder
+{
+public:
+	// MaxCost < 0 = nessun limite. OutPath = Start..Goal come indici cella, vuoto se irraggiungibile.
+	// La cella di partenza non viene controllata (di solito è occupata dall'unità che si muove).
+	bool FindPath(const FGridBoardState& Board, int32 StartIndex, int32 GoalIndex, int32 MaxCost, TArray<int32>& OutPath);
+
+	// Con la tabella statica (stesse dimensioni della board) l'euristica è la distanza a piedi
+	// senza unità: esatta finché nessuna unità sbarra la strada, e le query impossibili
+	// o oltre MaxCost falliscono senza espandere nulla. La tabella deve sopravvivere al pathfinder.
+	void SetStaticDistances(const FGridStaticDistances* InStaticDistances) { StaticDistances = InStaticDistances; }
+
+	// JumpPoint vale solo per le query senza limite (MaxCost < 0); quelle limitate restano A*.
+	// Stessa lunghezza del percorso A*, non necessariamente le stesse celle.
+	// Hierarchical qui vale come AStar: la gerarchia è FGridPathHierarchy, che usa questa classe come ripiego.
+	void SetBackend(EGridPathBackend InBackend) { Backend = InBackend; }
+	EGridPathBackend GetBackend() const { return Backend; }
+
+	// BFS limitata: un'unica visita al posto di una A* per cella
+	static void ComputeReachability(const FGridBoardState& Board, int32 OriginIndex, int32 MaxCost, FGridReachability& Out);
+
+	// Aggiorna InOut dopo modifiche alla board (celle da un FGridChangeLog) invece di rifare la BFS:
+	// si ricalcolano i sottoalberi dei predecessori che passano da celle cambiate e le celle che le
+	// celle liberate avvicinano. ReachedCells resta in ordine di distanza. Restituisce le celle toccate.
+	int32 RepairReachability(const FGridBoardState& Board, const TArray<int32>& ChangedCells, FGridReachability& InOut);
+
+	// celle espanse (jump point per JPS) dall'ultima query, utile per confronti/benchmark
+	int32 GetLastExpandedCount() const { return LastExpanded; }
+
+protected:
+	struct FOpenNode
+	{
+		int32 F;
+		int32 G;
+		int32 Index;
+	};
+
+	// a parità di F preferisce G maggiore (più vicino al goal)
+	struct FOpenNodeLess
+	{
+		FORCEINLINE bool operator()(const FOpenNode& A, const FOpenNode& B) const
+		{
+			return A.F < B.F || (A.F == B.F && A.G > B.G);
+		}
+	};
+
+	void BeginQuery(int32 NumCells);
+
+	FORCEINLINE bool IsSeen(int32 Index) const { return SeenStamp[Index] == Generation; }
+	FORCEINLINE bool IsClosed(int32 Index) const { return ClosedStamp[Index] == Generation; }
+
+	void BuildPath(int32 GoalIndex, TArray<int32>& OutPath) const;
+
+	bool FindJumpPointPath(const FGridBoardState& Board, int32 StartIndex, int32 GoalIndex, const uint8* GoalRow, TArray<int32>& OutPath);
+	void BuildJumpPointPath(int32 SizeY, int32 GoalIndex, TArray<int32>& OutPath) const;
+
+	// INDEX_NONE se la scansione esce dalla griglia o sbatte su una cella bloccata
+	static int32 JumpX(const FGridBoardState& Board, int32 X, int32 Y, int32 DX, int32 GoalIndex);
+	static int32 JumpY(const FGridBoardState& Board, int32 X, int32 Y, int32 DY, int32 GoalIndex);
+
+	static uint64 LoadBlockedBits(const FGridBoardState& Board, int32 X, int32 Y);
+
+	// muovendosi lungo Y di DY: la cella di lato è libera ma quella prima di lei no
+	static bool IsForced(const FGridBoardState& Board, int32 SideX, int32 Y, int32 DY);
+
+	static FORCEINLINE bool IsFree(const FGridBoardState& Board, int32 X, int32 Y)
+	{
+		return Board.IsValid(X, Y) && !Board.IsBlocked(Board.ToIndex(X, Y));
+	}
+
+	const FGridStaticDistances* StaticDistances = nullptr;
+	EGridPathBackend Backend = EGridPathBackend::AStar;
+
+	uint32 Generation = 0;
+	TArray<uint32> SeenStamp;
+	TArray<uint32> ClosedStamp;
+	TArray<int32> GScore;
+	TArray<int32> Parent;
+	TArray<FOpenNode> OpenHeap;
+	int32 LastExpanded = 0;
+
+	// RepairReachability: celle invalidate, celle riscritte
+	TArray<int32> RepairInvalid;
+	TArray<int32> RepairWritten;
+};
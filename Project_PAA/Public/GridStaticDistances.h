@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridBoardState.h"
+
+// Distanze a piedi tra tutte le coppie di celle considerando solo gli ostacoli (le unità no).
+// Una riga uint8 per cella sorgente (25x25 = 390 KB); simmetrica, d(A,B) = d(B,A).
+// Le distanze oltre MaxStored saturano: restano limiti inferiori, quindi euristiche ammissibili.
+// Le unità si gestiscono sopra: la distanza statica è un minimo, la BFS/A* sulla board dà quella vera.
+class PROJECT_PAA_API FGridStaticDistances
+{
+public:
+	static constexpr uint8 Unreachable = MAX_uint8;
+	static constexpr uint8 MaxStored = MAX_uint8 - 1;
+
+	// oltre questa dimensione la tabella (NumCells^2 byte) non viene costruita
+	static constexpr int32 MaxCells = 4096;
+
+	// una BFS per riga, righe in parallelo. False se la griglia è troppo grande
+	bool Build(const FGridBoardState& Board);
+	void Reset();
+
+	// da chiamare dopo aver cambiato un ostacolo sulla board.
+	// Rimozione: una BFS + rilassamento di tutte le coppie attraverso la cella.
+	// Aggiunta: ricalcola solo le righe con un percorso minimo che passava dalla cella.
+	void OnObstacleChanged(const FGridBoardState& Board, int32 Index);
+
+	bool IsBuilt() const { return NumCells > 0; }
+	bool Matches(const FGridBoardState& Board) const { return IsBuilt() && NumCells == Board.NumCells(); }
+
+	// una lettura; Unreachable se non collegate o se una delle due è un ostacolo
+	FORCEINLINE uint8 Get(int32 A, int32 B) const { return Table[A * NumCells + B]; }
+	FORCEINLINE const uint8* GetRow(int32 Source) const { return Table.GetData() + Source * NumCells; }
+
+	// INDEX_NONE se irraggiungibile
+	FORCEINLINE int32 GetDistance(int32 A, int32 B) const
+	{
+		const uint8 Distance = Get(A, B);
+		return Distance == Unreachable ? INDEX_NONE : Distance;
+	}
+
+	// righe ricalcolate dall'ultimo aggiornamento incrementale, utile per statistiche
+	int32 GetLastRebuiltRows() const { return LastRebuiltRows; }
+
+private:
+	void ComputeRows(const FGridBoardState& Board, const TArray<int32>& Sources);
+	static void ComputeRow(const FGridBoardState& Board, int32 Source, uint8* Row, TArray<int32>& Queue);
+
+	int32 NumCells = 0;
+	TArray<uint8> Table;
+	int32 LastRebuiltRows = 0;
+};
+
+// copia immutabile della tabella per i thread di ricerca, una per configurazione di ostacoli
+using FGridStaticDistancesSnapshot = TSharedPtr<const FGridStaticDistances, ESPMode::ThreadSafe>;
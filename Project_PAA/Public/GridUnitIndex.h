@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Indice spaziale delle unità per squadra: griglia di secchi BucketSize x BucketSize celle,
+// ogni secchio è una lista concatenata intrusiva per id (nessuna allocazione per spostamento).
+// Le query visitano solo i secchi che possono contenere risultati: costo proporzionale
+// ai secchi toccati più le unità trovate, non alla board né al numero totale di unità.
+// Gli id devono essere densi (UnitId del GridManager, slot della simulazione).
+class PROJECT_PAA_API FGridUnitIndex
+{
+public:
+	static constexpr int32 DefaultBucketSize = 4;
+	// fino a tante unità per squadra le query scorrono gli id: su una 25x25 visitare i secchi
+	// conviene solo oltre le 40-50 unità. Unico punto della scelta, chi usa l'indice non la ripete
+	static constexpr int32 DefaultLinearScanMaxUnits = 48;
+
+	// svuota l'indice e dimensiona i secchi per la griglia; con InLinearScanMaxUnits 0 si usano
+	// sempre i secchi (il benchmark li confronta con la scansione lineare)
+	void Init(int32 InSizeX, int32 InSizeY, int32 InBucketSize = DefaultBucketSize,
+		int32 InLinearScanMaxUnits = DefaultLinearScanMaxUnits);
+
+	// inserisce o sposta; CellIndex INDEX_NONE equivale a RemoveUnit
+	void SetUnit(int32 Id, int32 CellIndex, bool bPlayerTeam);
+	void RemoveUnit(int32 Id);
+	int32 GetUnitCell(int32 Id) const { return Cells.IsValidIndex(Id) ? Cells[Id] : INDEX_NONE; }
+
+	int32 Num(bool bPlayerTeam) const { return TeamCounts[bPlayerTeam ? 1 : 0]; }
+
+	// id della squadra entro distanza di Manhattan Radius da CenterIndex, per id crescente
+	void QueryRange(bool bPlayerTeam, int32 CenterIndex, int32 Radius, TArray<int32>& OutIds) const;
+
+	// i K più vicini per distanza di Manhattan (a pari distanza id più basso), dal più vicino;
+	// meno di K se la squadra ne ha meno
+	void FindNearest(bool bPlayerTeam, int32 CenterIndex, int32 K, TArray<int32>& OutIds) const;
+
+	// id con la Distance minima (a pari valore id più vicino in Manhattan), INDEX_NONE se squadra vuota.
+	// Distance non deve mai stare sotto la distanza di Manhattan (es. distanza a piedi): i candidati
+	// si esaminano in ordine di Manhattan e ci si ferma quando nessuno dei restanti può fare meglio
+	int32 FindNearestBy(bool bPlayerTeam, int32 CenterIndex, TFunctionRef<int32(int32 Id, int32 CellIndex)> Distance,
+		int32* OutDistance = nullptr) const;
+
+private:
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+	int32 BucketSize = DefaultBucketSize;
+	int32 BucketsX = 0;
+	int32 BucketsY = 0;
+	int32 LinearScanMaxUnits = DefaultLinearScanMaxUnits;
+
+	// testa della lista per secchio, una tabella per squadra (0 = IA, 1 = giocatore)
+	TArray<int32> Heads[2];
+	int32 TeamCounts[2] = { 0, 0 };
+
+	// per id: cella (con X e Y già separate, niente divisioni nelle query), squadra e collegamenti nella lista del secchio
+	TArray<int32> Cells;
+	TArray<FIntPoint> Coords;
+	TArray<uint8> Teams;
+	TArray<int32> Next;
+	TArray<int32> Prev;
+
+	int32 GetBucket(int32 CellIndex) const { return (CellIndex / SizeY) / BucketSize * BucketsY + (CellIndex % SizeY) / BucketSize; }
+	void Link(int32 Id);
+	void Unlink(int32 Id);
+
+	FORCEINLINE int32 GetManhattan(int32 Id, int32 X, int32 Y) const { return FMath::Abs(Coords[Id].X - X) + FMath::Abs(Coords[Id].Y - Y); }
+
+	// distanza minima tra la cella (X, Y) e una cella qualsiasi del secchio (BX, BY)
+	int32 GetBucketDistance(int32 X, int32 Y, int32 BX, int32 BY) const;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Sottosistemi con stream casuale indipendente: consumare numeri in uno
+// non sposta la sequenza degli altri (es. un highlight in più non cambia i danni)
+enum class EMatchRandomStream : uint8
+{
+	Obstacles,
+	Combat,
+	Counterattack,
+	Cosmetic,
+	CoinToss,
+	Placement,
+
+	Count
+};
+
+// PCG32 (XSH-RR): 64 bit di stato, sequenze indipendenti tramite Inc dispari
+struct PROJECT_PAA_API FPcg32
+{
+	uint64 State = 0x853c49e6748fea9bull;
+	uint64 Inc = 0xda3e39cb94b95bdbull;
+
+	FPcg32() = default;
+	FPcg32(uint64 InSeed, uint64 Sequence) { Seed(InSeed, Sequence); }
+
+	void Seed(uint64 InSeed, uint64 Sequence);
+
+	FORCEINLINE uint32 NextUInt32()
+	{
+		const uint64 OldState = State;
+		State = OldState * 6364136223846793005ull + Inc;
+		const uint32 XorShifted = static_cast<uint32>(((OldState >> 18u) ^ OldState) >> 27u);
+		const uint32 Rot = static_cast<uint32>(OldState >> 59u);
+		return (XorShifted >> Rot) | (XorShifted << ((0u - Rot) & 31u));
+	}
+
+	// [Min, Max] estremi inclusi, come FMath::RandRange
+	int32 RandRange(int32 Min, int32 Max);
+
+	// [0, 1)
+	FORCEINLINE float FRand() { return (NextUInt32() >> 8) * (1.0f / 16777216.0f); }
+	FORCEINLINE float FRandRange(float Min, float Max) { return Min + (Max - Min) * FRand(); }
+	FORCEINLINE bool RandBool() { return (NextUInt32() >> 31) != 0; }
+};
+
+// Generatore della partita: un seed, uno stream per sottosistema
+class PROJECT_PAA_API FMatchRandom
+{
+public:
+	void Initialize(uint64 InSeed);
+	bool IsInitialized() const { return bInitialized; }
+	uint64 GetSeed() const { return Seed; }
+
+	FPcg32& Stream(EMatchRandomStream Which) { return Streams[static_cast<int32>(Which)]; }
+
+	// stream indipendente e riproducibile per worker/simulazioni parallele
+	FPcg32 Fork(uint64 StreamIndex) const;
+
+private:
+	uint64 Seed = 0;
+	bool bInitialized = false;
+	FPcg32 Streams[static_cast<int32>(EMatchRandomStream::Count)];
+};
+
+// Stream della partita corrente (dal GameMode); fallback locale se non c'è un AMyGameMode
+PROJECT_PAA_API FPcg32& GetMatchRandomStream(const UObject* WorldContextObject, EMatchRandomStream Stream);
@@ -3,6 +3,8 @@
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
 #include "GlobalEnums.h"
+#include "MatchRandom.h"
+#include "TacticsSimulation.h"
 #include "MyGameMode.generated.h"
 
 
@@ -113,6 +115,8 @@ public:
 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
     bool bWaitingForMoveTarget; 
+    // sempre da qui: il GridManager tiene acceso il tick solo mentre si sceglie la destinazione
+    void SetWaitingForMoveTarget(bool bWaiting);
 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
     bool bWaitingForAttackTarget;
@@ -190,6 +194,17 @@ public:
     UPROPERTY(Transient)
     bool bActionPhaseStarted = false;
 
+    // Seed della partita (0 = casuale, loggato all'avvio); stesso seed = stessa partita
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gameplay")
+    int32 MatchSeed = 0;
+
+    // RNG della partita, inizializzato al primo uso
+    FMatchRandom& GetMatchRandom();
+
+    // Fotografia del mondo per le regole headless e scrittura del risultato sugli attori
+    bool BuildSimulationState(FTacticsGameState& OutState) const;
+    void ApplySimulationState(const FTacticsGameState& State);
+
     
 
 private:
@@ -206,5 +221,7 @@ private:
    
     bool bHasPlacedSniper = false;
     bool bHasPlacedBrawler = false;
+
+    FMatchRandom MatchRandom;
    
 };
\ No newline at end of file
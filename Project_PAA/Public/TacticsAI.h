@@ -0,0 +1,123 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TacticsSimulation.h"
+#include "GridUnitIndex.h"
+
+class FTacticsTranspositionTable;
+
+struct PROJECT_PAA_API FTacticsAISettings
+{
+	double TimeBudgetSeconds = 0.005; // per decisione
+	int32 MaxDepth = 6;               // in azioni di unità (mossa + attacco = 1)
+	int32 MaxMoveCandidates = 6;      // celle di destinazione valutate per unità
+};
+
+// Distanza a piedi (unità comprese) dalla cella più vicina da cui un attaccante di questo tipo
+// colpisce la squadra bersaglio, copiata da AGridManager::GetAttackDistanceField per la board
+// dello stato radice. Sulle celle delle unità che muovono vale la distanza dai vicini.
+struct PROJECT_PAA_API FTacticsApproachField
+{
+	bool bTargetPlayerTeam = false;
+	int32 AttackRange = 0;
+	bool bRanged = false;
+	uint32 BoardRevision = 0;
+	TArray<int32> Distance; // per cella, INDEX_NONE se nessuna cella d'attacco è raggiungibile
+};
+
+// Turno completo di un'unità: mossa (anche sul posto) più attacco opzionale
+struct PROJECT_PAA_API FTacticsUnitPlan
+{
+	int32 UnitSlot = INDEX_NONE;
+	int32 MoveCell = INDEX_NONE;
+	int32 TargetSlot = INDEX_NONE; // INDEX_NONE = nessun attacco
+	int32 OrderScore = 0;          // solo per l'ordinamento dei figli
+};
+
+struct PROJECT_PAA_API FTacticsAIStats
+{
+	int32 Nodes = 0;
+	int32 TableHits = 0; // nodi chiusi direttamente dalla tabella di trasposizione
+	int32 CompletedDepth = 0;
+	float BestValue = 0.f;
+	double ElapsedSeconds = 0.0;
+	bool bTimedOut = false;
+};
+
+// Expectimax con alpha-beta sui nodi max/min e nodi di chance sui tiri di danno
+// e contrattacco. Iterative deepening entro il budget di tempo: restituisce sempre
+// il piano dell'ultima profondità completata. Un'istanza per thread.
+class PROJECT_PAA_API FTacticsAI
+{
+public:
+	static constexpr float WinScore = 100000.f;
+	static constexpr float UnitAliveValue = 40.f;
+	static constexpr float HealthValue = 4.f;
+	static constexpr float ApproachPenalty = 1.f;
+
+	// miglior piano per la squadra di turno; false se nessuna unità può agire
+	bool FindBestPlan(const FTacticsGameState& State, const FTacticsAISettings& InSettings, FTacticsUnitPlan& OutPlan);
+
+	const FTacticsAIStats& GetLastStats() const { return Stats; }
+
+	// tabella condivisa (anche tra turni e thread); nullptr = nessuna
+	void SetTranspositionTable(FTacticsTranspositionTable* InTable) { TranspositionTable = InTable; }
+
+	// Campi per ordinare le destinazioni delle unità alla radice, al posto della distanza dal
+	// nemico più vicino di ScoreCell; usati solo se BoardRevision coincide. nullptr = nessuno
+	void SetApproachFields(const TArray<FTacticsApproachField>* InFields) { ApproachFields = InFields; }
+
+	// punteggio dal punto di vista dell'IA (> 0 = vantaggio IA)
+	static float Evaluate(const FTacticsGameState& State);
+
+	// piani della squadra di turno, ordinati dal più promettente
+	void GeneratePlans(const FTacticsGameState& State, int32 MaxMoveCandidates, TArray<FTacticsUnitPlan>& OutPlans);
+
+	// applica mossa e, se il piano non attacca, chiude il turno dell'unità
+	static void ApplyPlanMove(FTacticsGameState& State, const FTacticsUnitPlan& Plan);
+
+private:
+	struct FPlyScratch
+	{
+		FTacticsGameState MoveState;
+		FTacticsGameState RollState;
+		FTacticsGameState TurnState;
+		TArray<FTacticsUnitPlan> Plans;
+	};
+
+	struct FCandidateCell
+	{
+		int32 Cell;
+		int32 Score;
+	};
+
+	float Search(const FTacticsGameState& State, int32 Depth, int32 Ply, float Alpha, float Beta);
+	float SearchPlan(const FTacticsGameState& State, const FTacticsUnitPlan& Plan, int32 Depth, int32 Ply, float Alpha, float Beta);
+	float ExpectedAttackValue(const FTacticsGameState& AfterMove, const FTacticsUnitPlan& Plan, int32 Depth, int32 Ply);
+	float SearchRoll(const FTacticsGameState& AfterMove, const FTacticsUnitPlan& Plan, int32 Damage, int32 CounterDamage, int32 Depth, int32 Ply);
+	int32 ScoreCell(const FTacticsGameState& State, const FSimUnit& Unit, int32 Cell);
+	// nemici di Unit che può colpire da Cell, per slot crescente
+	void FindTargetsFrom(const FTacticsGameState& State, const FSimUnit& Unit, int32 Cell, TArray<int32>& OutSlots) const;
+	const FTacticsApproachField* FindApproachField(const FTacticsGameState& State, const FSimUnit& Unit) const;
+	static void PromotePlan(TArray<FTacticsUnitPlan>& Plans, const FTacticsUnitPlan& Plan);
+	bool IsOutOfTime();
+
+	FTacticsRules Rules;
+	FTacticsTranspositionTable* TranspositionTable = nullptr;
+	const TArray<FTacticsApproachField>* ApproachFields = nullptr;
+	bool bGeneratingRoot = false; // i campi valgono solo per lo stato radice
+	FTacticsAISettings Settings;
+	FTacticsAIStats Stats;
+
+	// scratch per ply, preallocato: nessuna allocazione durante la ricerca
+	TArray<FPlyScratch> Stack;
+	TArray<FTacticsUnitPlan> RootPlans;
+	TArray<FCandidateCell> Candidates;
+
+	// unità vive dello stato passato a GeneratePlans (id = slot)
+	FGridUnitIndex UnitIndex;
+	TArray<int32> TargetSlots;
+
+	double Deadline = 0.0;
+	bool bAborted = false;
+};
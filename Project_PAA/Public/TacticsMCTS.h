@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlobalEnums.h"
+#include "TacticsAI.h"
+
+class FMatchRandom;
+
+struct PROJECT_PAA_API FTacticsMCTSSettings
+{
+	double TimeBudgetSeconds = 0.02; // per decisione
+	int32 NumThreads = 0;            // 0 = tutti i worker del task graph
+	EAIRolloutPolicy RolloutPolicy = EAIRolloutPolicy::Greedy;
+	int32 RolloutTurns = 6;          // turni simulati prima di valutare
+	int32 MaxMoveCandidates = 6;
+	float Exploration = 0.7f;        // costante UCB1
+	int32 MaxTreeNodes = 200000;     // per worker
+	uint64 StreamBase = 0;           // stream RNG del worker = Fork(StreamBase + indice)
+};
+
+struct PROJECT_PAA_API FTacticsMCTSStats
+{
+	int32 Rollouts = 0;
+	int32 NumThreads = 0;
+	int32 BestVisits = 0;
+	float BestValue = 0.f; // ricompensa media dell'IA in [0, 1]
+	double ElapsedSeconds = 0.0;
+	double RolloutsPerSecond = 0.0;
+};
+
+// MCTS open-loop con parallelizzazione alla radice: ogni worker ha il suo albero,
+// le sue regole e il suo stream PCG; alla fine si sommano le visite dei figli della radice.
+// I dadi sono campionati ad ogni iterazione come in AUnitActions::AttackUnit,
+// quindi un figlio viene considerato solo se è legale nello stato campionato.
+class PROJECT_PAA_API FTacticsMCTS
+{
+public:
+	FTacticsMCTS();
+	~FTacticsMCTS();
+
+	bool FindBestPlan(const FTacticsGameState& State, const FTacticsMCTSSettings& Settings, const FMatchRandom& Random,
+		FTacticsUnitPlan& OutPlan);
+
+	const FTacticsMCTSStats& GetLastStats() const { return Stats; }
+
+private:
+	struct FWorker;
+
+	// workers persistenti: alberi e scratch riusati tra un turno e l'altro
+	TArray<TUniquePtr<FWorker>> Workers;
+	FTacticsMCTSStats Stats;
+};
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridBoardState.h"
+#include "GridPathfinder.h"
+#include "GridStaticDistances.h"
+#include "GridBitboard.h"
+
+class AGridManager;
+class AUnit;
+struct FPcg32;
+
+// Unità nella simulazione: solo dati, nessun puntatore ad attori
+struct PROJECT_PAA_API FSimUnit
+{
+	int32 UnitId = INDEX_NONE; // = AUnit::UnitId
+	int32 CellIndex = INDEX_NONE; // INDEX_NONE se distrutta
+
+	int32 Health = 0;
+	int32 MovementRange = 0;
+	int32 AttackRange = 0;
+	int32 MinDamage = 0;
+	int32 MaxDamage = 0;
+
+	bool bIsPlayer = false;
+	bool bIsRanged = false; // lo Sniper ignora gli ostacoli
+	bool bHasMoved = false;
+	bool bHasAttacked = false;
+
+	FORCEINLINE bool IsAlive() const { return Health > 0 && CellIndex != INDEX_NONE; }
+	FORCEINLINE bool CanAttack() const { return Health > 0 && !bHasAttacked; }
+};
+
+// Chiavi Zobrist senza tabella: SplitMix64 su (tipo, unità, valore) dà chiavi distinte
+// e ben distribuite per qualsiasi dimensione di griglia, senza inizializzazione
+struct PROJECT_PAA_API FTacticsZobrist
+{
+	static FORCEINLINE uint64 Key(uint64 Kind, int32 UnitId, int32 Value)
+	{
+		uint64 Z = (Kind << 60) ^ (static_cast<uint64>(static_cast<uint32>(UnitId)) << 32) ^ static_cast<uint32>(Value);
+		Z += 0x9e3779b97f4a7c15ull;
+		Z = (Z ^ (Z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		Z = (Z ^ (Z >> 27)) * 0x94d049bb133111ebull;
+		return Z ^ (Z >> 31);
+	}
+
+	static FORCEINLINE uint64 UnitCell(int32 UnitId, int32 CellIndex) { return Key(1, UnitId, CellIndex); }
+	// un bucket per punto vita: valori del TT esatti anche con HP vicini
+	static FORCEINLINE uint64 UnitHealth(int32 UnitId, int32 Health) { return Key(2, UnitId, FMath::Max(Health, 0)); }
+	static FORCEINLINE uint64 UnitMoved(int32 UnitId) { return Key(3, UnitId, 0); }
+	static FORCEINLINE uint64 UnitAttacked(int32 UnitId) { return Key(4, UnitId, 0); }
+	static FORCEINLINE uint64 PlayerToMove() { return Key(5, 0, 0); }
+};
+
+// Stato completo di una partita, copiabile a basso costo (ricerca IA, test, simulazioni).
+// Posizioni, HP, flag e turno vanno modificati con i setter, che aggiornano Hash.
+struct PROJECT_PAA_API FTacticsGameState
+{
+	FGridBoardState Board;
+	TArray<FSimUnit, TInlineAllocator<8>> Units;
+
+	bool bPlayerToMove = true;
+	int32 TurnNumber = 0;
+
+	// Zobrist di posizioni, HP, flag e squadra di turno
+	uint64 Hash = 0;
+
+	// tabella del GridManager, condivisa in sola lettura tra le copie; non posseduta: chi porta lo
+	// stato su un altro thread la sostituisce con GetStaticDistancesSnapshot e tiene vivo lo snapshot.
+	// nullptr se non disponibile o di dimensioni diverse dalla board
+	const FGridStaticDistances* StaticDistances = nullptr;
+
+	// distanza a piedi ignorando le unità; Manhattan senza tabella o tra celle non collegate
+	FORCEINLINE int32 GetWalkDistance(int32 A, int32 B) const
+	{
+		if (StaticDistances)
+		{
+			const uint8 Distance = StaticDistances->Get(A, B);
+			if (Distance != FGridStaticDistances::Unreachable) return Distance;
+		}
+		return Board.GetDistance(A, B);
+	}
+
+	uint64 ComputeHash() const;
+
+	void SetUnitCell(int32 Slot, int32 CellIndex); // INDEX_NONE = fuori dalla board
+	void SetUnitHealth(int32 Slot, int32 Health);
+	void SetHasMoved(int32 Slot, bool bValue);
+	void SetHasAttacked(int32 Slot, bool bValue);
+	void SetPlayerToMove(bool bValue);
+
+	int32 FindUnitSlot(int32 UnitId) const;
+	int32 FindUnitSlotAtCell(int32 CellIndex) const;
+	bool IsSideAlive(bool bPlayer) const;
+
+	// fotografia del mondo: board del GridManager + stato degli attori
+	static void Build(const AGridManager& Grid, const TArray<AUnit*>& PlayerUnits, const TArray<AUnit*>& AIUnits,
+		bool bPlayerToMove, FTacticsGameState& Out);
+};
+
+enum class ESimActionType : uint8
+{
+	Move,
+	Attack,
+	EndTurn
+};
+
+struct PROJECT_PAA_API FSimAction
+{
+	ESimActionType Type = ESimActionType::EndTurn;
+	int32 UnitSlot = INDEX_NONE;
+	int32 Target = INDEX_NONE; // Move: indice cella, Attack: slot unità bersaglio
+
+	static FSimAction Move(int32 Slot, int32 Cell) { return { ESimActionType::Move, Slot, Cell }; }
+	static FSimAction Attack(int32 Slot, int32 TargetSlot) { return { ESimActionType::Attack, Slot, TargetSlot }; }
+	static FSimAction EndTurn() { return {}; }
+};
+
+struct PROJECT_PAA_API FSimAttackResult
+{
+	int32 Damage = 0;
+	int32 CounterDamage = 0;
+	bool bCounterattack = false;
+	bool bTargetKilled = false;
+	bool bAttackerKilled = false;
+};
+
+// Regole del gioco su FTacticsGameState. Lo scratch di pathfinding è per istanza:
+// un'istanza per thread.
+class PROJECT_PAA_API FTacticsRules
+{
+public:
+	static constexpr int32 CounterMinDamage = 1;
+	static constexpr int32 CounterMaxDamage = 3;
+
+	bool CanMove(const FTacticsGameState& State, int32 UnitSlot, int32 TargetCell);
+	bool ApplyMove(FTacticsGameState& State, int32 UnitSlot, int32 TargetCell);
+
+	// mossa già validata (es. presa dalla reachability): nessuna BFS
+	static void ApplyMoveUnchecked(FTacticsGameState& State, int32 UnitSlot, int32 TargetCell);
+
+	// raggio d'attacco da una cella qualsiasi (il corpo a corpo solo adiacente)
+	static bool IsInAttackRange(const FGridBoardState& Board, const FSimUnit& Attacker, int32 FromCell, int32 TargetCell);
+
+	static bool CanAttack(const FTacticsGameState& State, int32 AttackerSlot, int32 TargetSlot);
+	static bool WouldCounterattack(const FTacticsGameState& State, int32 AttackerSlot, int32 TargetSlot, int32 Damage);
+
+	// tiri di dado dagli stream passati (danno, poi contrattacco solo se avviene)
+	bool ApplyAttack(FTacticsGameState& State, int32 AttackerSlot, int32 TargetSlot,
+		FPcg32& DamageRandom, FPcg32& CounterRandom, FSimAttackResult& OutResult);
+
+	// tiri già decisi (nodi di chance della ricerca); CounterDamage usato solo se c'è contrattacco
+	bool ApplyAttackWithRolls(FTacticsGameState& State, int32 AttackerSlot, int32 TargetSlot,
+		int32 Damage, int32 CounterDamage, FSimAttackResult& OutResult);
+
+	// passa il turno e riabilita le unità della squadra che inizia
+	static void EndTurn(FTacticsGameState& State);
+
+	// tutte le unità vive della squadra di turno hanno mosso e attaccato
+	static bool IsTurnComplete(const FTacticsGameState& State);
+
+	// mosse e attacchi disponibili alla squadra di turno, più EndTurn
+	void LegalActions(const FTacticsGameState& State, TArray<FSimAction>& OutActions);
+
+	bool ApplyAction(FTacticsGameState& State, const FSimAction& Action, FPcg32& DamageRandom, FPcg32& CounterRandom);
+
+	const FGridReachability& GetMoveReachability(const FTacticsGameState& State, int32 UnitSlot);
+
+private:
+	FGridReachability Reach;
+	FGridBitboard Bitboard;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TacticsAI.h"
+#include <atomic>
+
+enum class ETacticsBound : uint8
+{
+	None,
+	Exact,
+	Lower, // il valore vero è >= Value (taglio beta)
+	Upper  // il valore vero è <= Value (nessuna mossa ha superato alpha)
+};
+
+struct PROJECT_PAA_API FTacticsTTEntry
+{
+	float Value = 0.f;
+	int32 Depth = 0;
+	ETacticsBound Bound = ETacticsBound::None;
+	FTacticsUnitPlan BestPlan;
+};
+
+// Tabella di trasposizione a dimensione fissa, condivisa tra thread senza lock.
+// Ogni slot salva Key ^ Data0 ^ Data1: una scrittura concorrente lasciata a metà
+// non supera il controllo in lettura e viene trattata come slot vuoto.
+// Le voci sopravvivono tra un turno e l'altro; l'età le rende solo sostituibili.
+class PROJECT_PAA_API FTacticsTranspositionTable
+{
+public:
+	explicit FTacticsTranspositionTable(int32 SizeLog2 = 16);
+
+	void Resize(int32 SizeLog2);
+	void Clear();
+
+	// da chiamare prima di ogni ricerca, non durante
+	void NewSearch();
+
+	bool Probe(uint64 Key, FTacticsTTEntry& OutEntry) const;
+	void Store(uint64 Key, const FTacticsTTEntry& Entry);
+
+	int32 GetNumSlots() const { return static_cast<int32>(Mask + 1); }
+
+private:
+	struct FSlot
+	{
+		std::atomic<uint64> Check{ 0 };
+		std::atomic<uint64> Data0{ 0 }; // valore | profondità | bound | età
+		std::atomic<uint64> Data1{ 0 }; // piano migliore
+	};
+
+	TUniquePtr<FSlot[]> Slots;
+	uint64 Mask = 0;
+	uint8 Age = 1;
+};
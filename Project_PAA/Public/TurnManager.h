@@ -2,6 +2,10 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "GlobalEnums.h"
+#include "TacticsAI.h"
+#include "TacticsMCTS.h"
+#include "TacticsTranspositionTable.h"
+#include "MatchRandom.h"
 #include "TurnManager.generated.h"
 
 class AMyGameMode;
@@ -27,13 +31,85 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void CheckTurnCompletion(AMyGameMode* GameMode);
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	EAIMode AIMode = EAIMode::Expectimax;
+
+	// Budget di ricerca per ogni decisione dell'IA (una per unità)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	float AISearchBudgetMs = 5.f;
+
+	// Profondità massima in azioni di unità (mossa + attacco = 1)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 AISearchMaxDepth = 6;
+
+	// Celle di destinazione valutate per unità a ogni nodo
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	int32 AIMaxMoveCandidates = 6;
+
+	// Tabella di trasposizione dell'expectimax, riusata tra un turno e l'altro (2^N slot da 24 byte)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	bool bUseTranspositionTable = true;
+
+	UPROPERTY(EditAnywhere, Category = "AI", meta = (ClampMin = "4", ClampMax = "26"))
+	int32 TranspositionTableSizeLog2 = 16;
+
+	// MCTS: budget per decisione, thread (0 = tutti i core), policy e lunghezza dei rollout
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|MCTS")
+	float MCTSBudgetMs = 20.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|MCTS")
+	int32 MCTSThreads = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|MCTS")
+	EAIRolloutPolicy MCTSRolloutPolicy = EAIRolloutPolicy::Greedy;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|MCTS")
+	int32 MCTSRolloutTurns = 6;
+
 protected:
 	virtual void BeginPlay() override;
 
 private:
-	void ProcessAIMovement(AMyGameMode* GameMode);
-	void ProcessAIAttacks(AMyGameMode* GameMode);
-	AUnit* FindNearestEnemy(AUnit* AIUnit);
-	bool FindMovePositionForAI(AUnit* AIUnit, FVector2D& OutBestPosition);
-	
+	bool ExecuteAIPlan(AMyGameMode* GameMode, const FTacticsGameState& State, const FTacticsUnitPlan& Plan);
+
+	// Impostazioni di una ricerca, lette dalle UPROPERTY sul game thread prima di lanciarla
+	struct FAIPlanRequest
+	{
+		EAIMode Mode = EAIMode::Expectimax;
+		FTacticsAISettings AISettings;
+		bool bUseTranspositionTable = true;
+		FTacticsMCTSSettings MCTSSettings;
+		FMatchRandom Random;
+
+		// copie dei campi d'attacco del GridManager, una per tipo di unità IA
+		TArray<FTacticsApproachField> ApproachFields;
+	};
+
+	// Motori di ricerca usati dal worker: condivisi, così restano vivi fino alla fine della ricerca
+	// anche se il TurnManager viene distrutto prima. Una sola ricerca alla volta.
+	struct FAIPlanner
+	{
+		FTacticsAI Search;
+		FTacticsTranspositionTable TranspositionTable;
+		FTacticsMCTS MCTSSearch;
+	};
+
+	FAIPlanRequest MakeAIPlanRequest(AMyGameMode* GameMode);
+	static bool FindAIPlan(FAIPlanner& InPlanner, const FAIPlanRequest& Request, const FTacticsGameState& State, FTacticsUnitPlan& OutPlan);
+	// un campo d'attacco del GridManager per tipo di unità IA, da passare alla ricerca
+	static void BuildApproachFields(AMyGameMode* GameMode, TArray<FTacticsApproachField>& OutFields);
+
+	// Turno IA a passi: stato costruito sul game thread, ricerca su un worker, piano eseguito
+	// di nuovo sul game thread. Nessun frame aspetta la ricerca.
+	void RunNextAIStep();
+	void OnAIPlanReady(const FTacticsGameState& State, bool bFound, const FTacticsUnitPlan& Plan);
+	void FinishAITurn();
+
+	TSharedRef<FAIPlanner, ESPMode::ThreadSafe> Planner;
+	uint64 MCTSSearchCount = 0;
+
+	TWeakObjectPtr<AMyGameMode> AITurnGameMode;
+	TArray<int32> AIActedUnitIds;
+	int32 AIStepsLeft = 0;
+	bool bAITurnInProgress = false;
 };
\ No newline at end of file
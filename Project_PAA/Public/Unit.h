@@ -53,6 +53,10 @@ public:
 	UPROPERTY(VisibleAnywhere)
 	bool bIsSelected = false;
 
+	// assegnato da AGridManager::RegisterUnit, indice nella board
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 UnitId = INDEX_NONE;
+
 
 	UFUNCTION(BlueprintCallable)
 	void SetSelected(bool bSelected);
@@ -72,9 +76,6 @@ public:
 	void MoveToCell(FVector2D NewPosition);
 	void DestroyUnit();
 
-	UFUNCTION()
-	void OnClicked(UPrimitiveComponent* ClickedComp, FKey ButtonPressed);
-
 	UFUNCTION(BlueprintCallable)
    virtual bool IsSniper() const { return false; }
 	
@@ -86,6 +87,6 @@ protected:
 	
 
 private:
-	FVector2D GridPosition;
+	FVector2D GridPosition = FVector2D(-1, -1);
 	AGridManager* GetGridManager() const;
 };
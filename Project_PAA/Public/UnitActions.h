@@ -1,6 +1,7 @@
 #pragma once
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "TacticsSimulation.h"
 #include "UnitActions.generated.h"
 
 class AUnit;
@@ -33,4 +34,7 @@ private:
 	bool IsValidMove(AUnit* Unit, FVector2D TargetPosition);
 	bool IsValidAttack(AUnit* Attacker, AUnit* Target);
 	AGridManager* GetGridManager() const;
+
+	// regole condivise con la simulazione (mosse, attacchi, contrattacchi)
+	FTacticsRules Rules;
 };
\ No newline at end of file